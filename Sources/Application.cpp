@@ -22,6 +22,7 @@
  */
 
 #include "Application.h"
+#include "jConsole.h"
 
 namespace Kiwi
 {
@@ -77,13 +78,27 @@ namespace Kiwi
     
     void Application::initialise(const String& commandLine)
     {
+        const StringArray arguments = StringArray::fromTokens(commandLine, true);
+        m_is_running_command_line = arguments.contains("--headless");
+        if(m_is_running_command_line)
+        {
+            initConsoleSink(arguments);
+        }
+        else
+        {
+            m_history = jConsoleHistory::create();
+        }
+        
 		juce::Process::setPriority(juce::Process::RealtimePriority);
 		initCommandManager();
 		m_dsp_device_manager = make_shared<KiwiJuceDspDeviceManager>();
         m_gui_device_manager = make_shared<KiwiJuceGuiDeviceManager>();
         m_gui_device_manager->initialize();
-        m_instance = jInstance::create(m_gui_device_manager, m_dsp_device_manager, "main");
-        m_menu_model = new MainMenuModel();
+        m_instance = jInstance::create(m_gui_device_manager, m_dsp_device_manager, "main", m_is_running_command_line);
+        if(!m_is_running_command_line)
+        {
+            m_menu_model = new MainMenuModel();
+        }
         
         /*
 #if JUCE_MAC
@@ -97,12 +112,56 @@ namespace Kiwi
         
     }
     
+    void Application::initConsoleSink(StringArray const& arguments)
+    {
+        jConsoleSink::Format format = jConsoleSink::Json;
+        const int formatIndex = arguments.indexOf("--log-format");
+        if(formatIndex >= 0 && arguments[formatIndex + 1] == "binary")
+        {
+            format = jConsoleSink::Binary;
+        }
+        
+        OutputStream* stream = nullptr;
+        const int fileIndex = arguments.indexOf("--log");
+        if(fileIndex >= 0 && arguments[fileIndex + 1].isNotEmpty())
+        {
+            ScopedPointer<FileOutputStream> file = new FileOutputStream(File::getCurrentWorkingDirectory().getChildFile(arguments[fileIndex + 1].unquoted()));
+            if(file->openedOk())
+            {
+                stream = file.release();
+            }
+        }
+        
+        const bool failed = fileIndex >= 0 && !stream;
+        if(!stream)
+        {
+            stream = jConsoleSink::createStandardOutputStream();
+        }
+        m_sink = jConsoleSink::create(stream, format);
+        if(failed)
+        {
+            Console::error("The log file can't be opened, the console messages are written to the standard output.");
+        }
+    }
+    
     void Application::shutdown()
     {
 #if JUCE_MAC
         MenuBarModel::setMacMainMenu(nullptr);
 #endif
         m_instance.reset();
+        if(m_sink)
+        {
+            Console::unbind(m_sink);
+            m_sink.reset();
+        }
+        
+        // The history runs a timer, it's released while the message manager still exists.
+        if(m_history)
+        {
+            Console::unbind(m_history);
+            m_history.reset();
+        }
     }
     
     void Application::suspended()
@@ -160,6 +219,11 @@ namespace Kiwi
 		return instance;
 	}
 	
+	shared_ptr<jConsoleHistory> Application::getConsoleHistory()
+	{
+		return getApp().m_history;
+	}
+	
     //==============================================================================
     StringArray Application::getMenuNames()
     {
@@ -25,6 +25,7 @@
 #define __DEF_KIWI_APPLICATION__
 
 #include "jInstance.h"
+#include "jConsoleSink.h"
 //#include "DspJuce.h"
 
 //! The Kiwi Application, where all the magic starts !
@@ -46,6 +47,11 @@ namespace Kiwi
         //! Initialise the command manager
         void initCommandManager();
         
+        //! Initialise the console sink when the application runs from the command line
+        /** The arguments are --headless to run without graphical interface, --log followed by a file to write the console messages to a file instead of the standard output and --log-format followed by json or binary.
+         */
+        void initConsoleSink(StringArray const& arguments);
+        
         //! Called by MainMenuModel to get the menu names
         StringArray getMenuNames();
         
@@ -72,6 +78,8 @@ namespace Kiwi
         shared_ptr<KiwiJuceGuiDeviceManager>        m_gui_device_manager;
         sjInstance									m_instance;
         ScopedPointer<MainMenuModel>				m_menu_model;
+        shared_ptr<jConsoleSink>                    m_sink;
+        shared_ptr<jConsoleHistory>                 m_history;
         bool										m_is_running_command_line;
     public:
         
@@ -124,6 +132,11 @@ namespace Kiwi
 		/** The function retrieves the current running kiwi instance.
 		 */
 		static sjInstance getKiwiInstance();
+		
+		//! Retrieve the console history of the application.
+		/** The function retrieves the history that the consoles show, it's created at startup and released at shutdown, there is no history when the application runs without graphical interface.
+		 */
+		static shared_ptr<jConsoleHistory> getConsoleHistory();
         
         // ================================================================================ //
         //                              APPLICATION COMMAND TARGET                          //
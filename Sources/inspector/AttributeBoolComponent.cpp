@@ -61,19 +61,18 @@ namespace Kiwi
 	
 	void AttributeBoolComponent::refresh()
 	{
-		ElemVector state;
-		getAttributeValue(state);
-		bool val = false;
+		long state;
 		
-		if (!state.empty())
+		// A recycled row mustn't keep the state of its previous attribute when the value can't be read.
+		if (! getAttributeValue(state))
 		{
-			val = (long)state[0];
-			button.setToggleState (val, dontSendNotification);
+			state = 0;
 		}
+		button.setToggleState (state != 0, dontSendNotification);
 	}
 	
 	void AttributeBoolComponent::buttonClicked (Button*)
 	{
-		setAttributeValue({ (long) !getState() });
+		setAttributeValue((long) !getState());
 	}	
 }
\ No newline at end of file
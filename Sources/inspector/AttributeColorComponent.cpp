@@ -26,7 +26,8 @@
 namespace Kiwi
 {
 	AttributeColorComponent::AttributeColorComponent (sAttr attribute, Attr::sManager attrsManager)
-	: AttributeComponent (attribute, attrsManager)
+	: AttributeComponent (attribute, attrsManager),
+	m_swatch_scale (0.f)
 	{
 		m_color.addListener(this);
 	}
@@ -43,13 +44,31 @@ namespace Kiwi
 		const juce::Rectangle<int> rect = getAttributeContentComponentArea();
 		
 		const Colour colour (getColour());
+		const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+		const int width	  = roundToInt (rect.getWidth() * scale);
+		const int height  = roundToInt (rect.getHeight() * scale);
 		
-		g.setColour(Colours::lightgrey.contrasting(0.3f).withAlpha(0.8f));
-		g.fillRect(rect);
-		g.fillCheckerBoard (rect.reduced(2),
-							10, 10,
-							Colour(0xffcdcdcd).overlaidWith(colour),
-							Colour(0xffdedede).overlaidWith(colour));
+		// The swatch is rendered again only if the colour, the size or the scale changes.
+		if (m_swatch.isNull() || m_swatch_colour != colour || m_swatch_scale != scale
+			|| m_swatch.getWidth() != width || m_swatch.getHeight() != height)
+		{
+			m_swatch_colour	= colour;
+			m_swatch_scale	= scale;
+			m_swatch		= Image (Image::ARGB, jmax (1, width), jmax (1, height), true);
+			
+			Graphics sg (m_swatch);
+			sg.addTransform (AffineTransform::scale (scale));
+			
+			const juce::Rectangle<int> bounds (0, 0, rect.getWidth(), rect.getHeight());
+			sg.setColour(Colours::lightgrey.contrasting(0.3f).withAlpha(0.8f));
+			sg.fillRect(bounds);
+			sg.fillCheckerBoard (bounds.reduced(2),
+								 10, 10,
+								 Colour(0xffcdcdcd).overlaidWith(colour),
+								 Colour(0xffdedede).overlaidWith(colour));
+		}
+		
+		g.drawImage (m_swatch, rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(), 0, 0, m_swatch.getWidth(), m_swatch.getHeight());
 	}
 	
 	Colour AttributeColorComponent::getColour() const
@@ -76,32 +95,23 @@ namespace Kiwi
 	
 	void AttributeColorComponent::refresh()
 	{
-		ElemVector attrval;
-		getAttributeValue(attrval);
+		Colour colour;
 		
-		if (!attrval.empty())
+		// A recycled row mustn't keep the colour of its previous attribute when the value can't be read.
+		if (! getAttributeValue(colour))
 		{
-			float red, green, blue, alpha;
-			const ElemVector::size_type size = attrval.size();
-			
-			if(size && attrval[0].isNumber())
-			{
-				red = clip((double)attrval[0], 0., 1.);
-			}
-			if(size > 1 && attrval[1].isNumber())
+			if (m_color.toString().isNotEmpty())
 			{
-				green = clip((double)attrval[1], 0., 1.);
+				m_lastcolor = Colour();
+				m_color = String::empty;
+				
+				repaint();
 			}
-			if(size > 2 && attrval[2].isNumber())
-			{
-				blue = clip((double)attrval[2], 0., 1.);
-			}
-			if(size > 3 && attrval[3].isNumber())
-			{
-				alpha = clip((double)attrval[3], 0., 1.);
-			}
-			
-			m_color = Colour::fromFloatRGBA(red, green, blue, alpha).toDisplayString(true);
+		}
+		else if (colour != m_lastcolor || m_color.toString().isEmpty())
+		{
+			m_lastcolor = colour;
+			m_color = colour.toDisplayString(true);
 			
 			repaint();
 		}
@@ -114,7 +124,7 @@ namespace Kiwi
 			const Colour col = getColour();
 
 			if (col != m_lastcolor)
-				setAttributeValue({(double)col.getFloatRed(), (double)col.getFloatGreen(), (double)col.getFloatBlue(), (double)col.getFloatAlpha()});
+				setAttributeValue(col);
 
 			m_lastcolor = col;
 		}
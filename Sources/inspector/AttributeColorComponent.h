@@ -120,6 +120,9 @@ namespace Kiwi
 	private:
 		Value			m_color;
 		Colour			m_lastcolor;
+		Image			m_swatch;
+		Colour			m_swatch_colour;
+		float			m_swatch_scale;
 		
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AttributeColorComponent)
 	};
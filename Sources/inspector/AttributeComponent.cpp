@@ -22,22 +22,40 @@
  */
 
 #include "AttributeComponent.h"
+#include "AttributePanel.h"
 
 namespace Kiwi
 {
 	AttributeComponent::AttributeComponent(sAttr attribute, Attr::sManager attrsManager, int preferredHeight)
 		: m_preferred_height(preferredHeight),
 		  m_attr(attribute),
-		  m_manager(attrsManager)
+		  m_manager(attrsManager),
+		  m_background_scale(0.f),
+		  m_has_pending(false),
+		  m_gesture(false)
 	{
 		setEnabled(!m_attr->isDisabled());
 	}
 	
 	AttributeComponent::~AttributeComponent()
 	{
-		if (m_manager && m_attr)
+		endEditGesture();
+	}
+	
+	void AttributeComponent::setAttribute(sAttr attribute, Attr::sManager attrsManager)
+	{
+		// A recycled component first commits the edit of its previous attribute.
+		endEditGesture();
+		
+		m_attr		= attribute;
+		m_manager	= attrsManager;
+		m_background = Image();
+		
+		if (m_attr)
 		{
-			;//m_manager->unbind(shared_from_this());
+			setEnabled(!m_attr->isDisabled());
+			attributeChanged();
+			refresh();
 		}
 	}
 	
@@ -53,12 +71,132 @@ namespace Kiwi
 	
 	void AttributeComponent::setAttributeValue(ElemVector const& elements)
 	{
-		/*
+		if (m_gesture)
+		{
+			m_pending		= elements;
+			m_has_pending	= true;
+		}
+		else
+		{
+			commitAttributeValue(elements);
+		}
+	}
+	
+	bool AttributeComponent::getAttributeValue(double& value)
+	{
+		m_value.clear();
+		getAttributeValue(m_value);
+		
+		if (!m_value.empty() && m_value[0].isNumber())
+		{
+			value = (double)m_value[0];
+			return true;
+		}
+		return false;
+	}
+	
+	bool AttributeComponent::getAttributeValue(long& value)
+	{
+		m_value.clear();
+		getAttributeValue(m_value);
+		
+		if (!m_value.empty() && m_value[0].isNumber())
+		{
+			value = (long)m_value[0];
+			return true;
+		}
+		return false;
+	}
+	
+	bool AttributeComponent::getAttributeValue(Colour& colour)
+	{
+		m_value.clear();
+		getAttributeValue(m_value);
+		
+		if (!m_value.empty() && m_value[0].isNumber())
+		{
+			float rgba[4] = {0.f, 0.f, 0.f, 1.f};
+			const ElemVector::size_type size = min(m_value.size(), ElemVector::size_type(4));
+			
+			for (ElemVector::size_type i = 0; i < size && m_value[i].isNumber(); i++)
+			{
+				rgba[i] = (float)clip((double)m_value[i], 0., 1.);
+			}
+			
+			colour = Colour::fromFloatRGBA(rgba[0], rgba[1], rgba[2], rgba[3]);
+			return true;
+		}
+		return false;
+	}
+	
+	void AttributeComponent::setAttributeValue(double value)
+	{
+		m_value.clear();
+		m_value.push_back(value);
+		setAttributeValue(m_value);
+	}
+	
+	void AttributeComponent::setAttributeValue(long value)
+	{
+		m_value.clear();
+		m_value.push_back(value);
+		setAttributeValue(m_value);
+	}
+	
+	void AttributeComponent::setAttributeValue(Colour const& colour)
+	{
+		m_value.clear();
+		m_value.push_back((double)colour.getFloatRed());
+		m_value.push_back((double)colour.getFloatGreen());
+		m_value.push_back((double)colour.getFloatBlue());
+		m_value.push_back((double)colour.getFloatAlpha());
+		setAttributeValue(m_value);
+	}
+	
+	void AttributeComponent::beginEditGesture()
+	{
+		if (!m_gesture && m_manager && m_attr)
+		{
+			m_gesture = true;
+			startTimer(1000 / 60);
+		}
+	}
+	
+	void AttributeComponent::endEditGesture()
+	{
+		if (m_gesture)
+		{
+			stopTimer();
+			
+			if (m_has_pending)
+			{
+				commitAttributeValue(m_pending);
+				m_has_pending = false;
+			}
+			
+			m_gesture = false;
+		}
+	}
+	
+	void AttributeComponent::timerCallback()
+	{
+		if (m_has_pending)
+		{
+			commitAttributeValue(m_pending);
+			m_has_pending = false;
+		}
+	}
+	
+	void AttributeComponent::commitAttributeValue(ElemVector const& elements)
+	{
 		if (m_manager && m_attr)
 		{
-			m_manager->setAttributeValue(m_attr->getName(), elements);
+			AttributePanel* panel = findParentComponentOfClass<AttributePanel>();
+			if (panel)
+			{
+				panel->setAttributeValue(m_manager, m_attr, elements);
+			}
 		}
-		*/
 	}
 	
 	const String AttributeComponent::getAttrName() const noexcept
@@ -85,6 +223,25 @@ namespace Kiwi
 	
 	void AttributeComponent::paint(Graphics& g)
 	{
+		// The background and the label are rendered once in an image, scrolling the panel only draws the image.
+		const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+		
+		if (m_background.isNull() || m_background_scale != scale)
+		{
+			renderBackground (scale);
+		}
+		
+		g.drawImage (m_background, 0, 0, getWidth(), getHeight(), 0, 0, m_background.getWidth(), m_background.getHeight());
+	}
+	
+	void AttributeComponent::renderBackground(const float scale)
+	{
+		m_background_scale	= scale;
+		m_background		= Image (Image::ARGB, jmax (1, roundToInt (getWidth() * scale)), jmax (1, roundToInt (getHeight() * scale)), true);
+		
+		Graphics g (m_background);
+		g.addTransform (AffineTransform::scale (scale));
+		
 		//@see juce::drawPropertyComponentBackground
 		g.setColour (findColour (backgroundColourId));
 		g.fillRect (0, 0, getWidth(), getHeight() - 1);
@@ -116,26 +273,10 @@ namespace Kiwi
 		}
 	}
 	
-	void AttributeComponent::notify(sAttr attr)
-	{
-		if(attr == m_attr)
-		{
-			refresh();
-			/*
-			if (type == Attr::Notification::ValueChanged)
-			{
-				refresh();
-			}
-			else if(type == Attr::Notification::BehaviorChanged)
-			{
-				setEnabled(!m_attr->isDisabled());
-			}
-			*/
-		}
-	}
-	
 	void AttributeComponent::resized()
 	{
+		m_background = Image();
+		
 		if (Component* const c = getChildComponent(0))
 		{
 			c->setBounds(getAttributeContentComponentArea());
@@ -151,6 +292,19 @@ namespace Kiwi
 	
 	void AttributeComponent::enablementChanged()
 	{
+		m_background = Image();
+		repaint();
+	}
+	
+	void AttributeComponent::colourChanged()
+	{
+		m_background = Image();
+		repaint();
+	}
+	
+	void AttributeComponent::lookAndFeelChanged()
+	{
+		m_background = Image();
 		repaint();
 	}
 }
\ No newline at end of file
@@ -40,17 +40,25 @@ namespace Kiwi
 	 shows its value as draggable/editable number object; an AttributeTextComponent as a text object, etc.
 	 
 	 A subclass must implement the refresh() method which will be called to tell the
-	 component to update itself, and is also responsible for calling it when the
-	 item that it refers to is changed.
+	 component to update itself. The component doesn't listen to the attribute, the
+	 panel that owns it listens to the manager and calls refresh() at most once per
+	 display frame however often the attribute changes.
+	 
+	 The same goes for the writes: between beginEditGesture() and endEditGesture(), like
+	 while the user drags a value, the values are only committed once per display frame
+	 and the last one is committed when the gesture ends.
 	 
 	 @see Attribute, AttributePanel, AttributeTextComponent, AttributeNumberComponent,
 	 AttributeMenuComponent, AttributeBoolComponent
 	 */
 	class AttributeComponent  : public Component, public SettableTooltipClient,
-								public Attr::Listener,
-								public enable_shared_from_this<AttributeComponent>
+								public enable_shared_from_this<AttributeComponent>,
+								private Timer
 	{
 	public:
+		/** The height of a row when the component doesn't need to be larger. */
+		static const int defaultHeight = 25;
+		
 		//==============================================================================
 		/** Creates an AttributeComponent.
 		 
@@ -62,14 +70,13 @@ namespace Kiwi
 		 This value can also be set if a subclass changes the
 		 preferredHeight member variable.
 		 */
-		AttributeComponent (sAttr attribute, Attr::sManager attrsManager, int preferredHeight = 25);
+		AttributeComponent (sAttr attribute, Attr::sManager attrsManager, int preferredHeight = defaultHeight);
 		
 		/** Destructor. */
 		~AttributeComponent();
 		
 		//! Attribute component creator.
-		/** This static method creates and returns a shared pointer of an AttributeComponent and bind it to an Attr::Manager.
-		 @param attrsManager A shared pointer of an Attribute::Manager to watch.
+		/** This static method creates and returns a shared pointer of an AttributeComponent and refreshes it.
 		 @return    A shared pointer of an AttributeComponent.
 		 */
 		template<class compClass, class ...Args> static shared_ptr<compClass> create(Args&& ...arguments)
@@ -77,23 +84,11 @@ namespace Kiwi
 			shared_ptr<compClass> cp = make_shared<compClass>(forward<Args>(arguments)...);
 			if(cp)
 			{
-                if(cp->m_manager)
-                {
-                    cp->m_manager->bind(cp);
-                }
 				cp->refresh();
 			}
 			return cp;
 		}
 		
-		//! Receive the notification that an attribute has changed.
-		/** Receive notifications when an attribute is added or removed, or when its value, appearance or behavior changes.
-		 @param manager		The Attribute::Manager that manages the attribute.
-		 @param attr		The attribute that has been modified.
-		 @type type			The type of notification
-		 */
-		void notify(sAttr attr) override;
-		
 		//==============================================================================
 		/** Returns this item's preferred height.
 		 
@@ -104,6 +99,14 @@ namespace Kiwi
 		
 		void setPreferredHeight (int newHeight) noexcept        { m_preferred_height = newHeight; }
 		
+		/** Binds the component to another attribute.
+		 
+		 The panel recycles the components of the rows that scroll out of view, the component
+		 is then refreshed with the value of the new attribute.
+		 A null attribute only detaches the component.
+		 */
+		void setAttribute (sAttr attribute, Attr::sManager attrsManager);
+		
 		/** Retrieves the area of the attribute value component
 		 */
 		juce::Rectangle<int> getAttributeContentComponentArea();
@@ -126,9 +129,51 @@ namespace Kiwi
 		void getAttributeValue(ElemVector& elements);
 		
 		/** Sets the attribute value
+		 The value is written by the panel that owns the component. During an edit gesture
+		 the value is kept and committed at the next frame, only the last one is written.
+		 @see AttributePanel::setAttributeValue, beginEditGesture
 		 */
 		void setAttributeValue(ElemVector const& elements);
 		
+		/** Retrieves the attribute value as a number.
+		 The typed accessors read and write through a buffer owned by the component, so
+		 refreshing or editing a component doesn't allocate once the buffer has grown.
+		 @return true if the attribute value starts with a number.
+		 */
+		bool getAttributeValue(double& value);
+		
+		/** Retrieves the attribute value as an integer, like a toggle state or the index of an enum.
+		 @return true if the attribute value starts with a number.
+		 */
+		bool getAttributeValue(long& value);
+		
+		/** Retrieves the attribute value as a colour from its red, green, blue and alpha values.
+		 @return true if the attribute value starts with a number.
+		 */
+		bool getAttributeValue(Colour& colour);
+		
+		/** Sets the attribute value to a number. */
+		void setAttributeValue(double value);
+		
+		/** Sets the attribute value to an integer, like a toggle state or the index of an enum. */
+		void setAttributeValue(long value);
+		
+		/** Sets the attribute value to the red, green, blue and alpha values of a colour. */
+		void setAttributeValue(Colour const& colour);
+		
+		/** Starts a continuous edit, like a drag.
+		 Until endEditGesture() is called, the values are committed at most once per frame.
+		 */
+		void beginEditGesture();
+		
+		/** Ends a continuous edit.
+		 The last pending value is committed.
+		 */
+		void endEditGesture();
+		
+		/** Returns true if an edit gesture is in progress. */
+		bool isInEditGesture() const noexcept { return m_gesture; }
+		
 		/** The default paint method fills the background and draws a label for the
 		 item's name.
 		 
@@ -151,6 +196,12 @@ namespace Kiwi
 		/** By default, this just repaints the component. */
 		virtual void enablementChanged() override;
 		
+		/** Clears the cached background when one of the colours changes. */
+		void colourChanged() override;
+		
+		/** Clears the cached background when the look and feel changes. */
+		void lookAndFeelChanged() override;
+		
 		//==============================================================================
 		/** A set of colour IDs to use to change the colour of various aspects of attribute component.
 		 
@@ -168,6 +219,13 @@ namespace Kiwi
 		};
 		
 	protected:
+		/** Called when the component has been bound to another attribute.
+		 
+		 A subclass that depends on the attribute beyond its value, like the items of a menu,
+		 can override this method to update itself before the refresh.
+		 */
+		virtual void attributeChanged() {}
+		
 		/** Used by the AttributePanel to determine how high this component needs to be.
 		 A subclass can update this value in its constructor but shouldn't alter it later
 		 as changes won't necessarily be picked up.
@@ -178,6 +236,16 @@ namespace Kiwi
 		Attr::sManager	m_manager;
 
 	private:
+		Image			m_background;
+		float			m_background_scale;
+		ElemVector		m_value;
+		ElemVector		m_pending;
+		bool			m_has_pending;
+		bool			m_gesture;
+		
+		void commitAttributeValue(ElemVector const& elements);
+		void renderBackground(const float scale);
+		void timerCallback() override;
 		
 		const String getAttrName() const noexcept;
 		const String getAttrLabel() const noexcept;
@@ -38,7 +38,12 @@ namespace Kiwi
 	void AttributeMenuComponent::createComboBox()
 	{
 		addAndMakeVisible (m_combo_box);
-		
+		fillComboBox();
+		m_combo_box.setEditableText (false);
+	}
+	
+	void AttributeMenuComponent::fillComboBox()
+	{
 		ElemVector elemValues;
 		m_attr->getEnumValues(elemValues);
 		
@@ -46,8 +51,15 @@ namespace Kiwi
 		{
 			m_combo_box.addItem(toString(elemValues[i]), i + 1);
 		}
-		
-		m_combo_box.setEditableText (false);
+	}
+	
+	void AttributeMenuComponent::attributeChanged()
+	{
+		if (m_combo_box.isVisible())
+		{
+			m_combo_box.clear (dontSendNotification);
+			fillComboBox();
+		}
 	}
 	
 	//==============================================================================
@@ -59,18 +71,22 @@ namespace Kiwi
 			m_combo_box.addListener (this);
 		}
 		
-		ElemVector state;
-		getAttributeValue(state);
+		long index;
 		
-		if (!state.empty())
+		// A recycled row mustn't keep the item of its previous attribute when the value can't be read.
+		if (getAttributeValue(index))
+		{
+			m_combo_box.setSelectedId ((int)index + 1, dontSendNotification);
+		}
+		else
 		{
-			m_combo_box.setSelectedId ((long)state[0] + 1, dontSendNotification);
+			m_combo_box.setSelectedId (0, dontSendNotification);
 		}
 	}
 	
 	void AttributeMenuComponent::comboBoxChanged (ComboBox*)
 	{
 		const int newIndex = m_combo_box.getSelectedId() - 1;
-		setAttributeValue({ (long) newIndex });
+		setAttributeValue((long) newIndex);
 	}
 }
\ No newline at end of file
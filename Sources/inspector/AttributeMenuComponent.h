@@ -53,9 +53,14 @@ namespace Kiwi
 		/** @internal */
 		void refresh();
 		
+	protected:
+		/** @internal */
+		void attributeChanged() override;
+		
 	private:
 		ComboBox m_combo_box;
 		void createComboBox();
+		void fillComboBox();
 		void comboBoxChanged (ComboBox*);
 		
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AttributeMenuComponent)
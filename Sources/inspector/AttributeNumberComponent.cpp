@@ -38,10 +38,12 @@ namespace Kiwi
 		m_numberbox.setFloatingPointStyle(m_flonum);
 		m_numberbox.setMinMax(rangeMin, rangeMax, 0.001);
 		m_numberbox.addChangeListener(this);
+		m_numberbox.addMouseListener(this, false);
 	}
 	
 	AttributeNumberComponent::~AttributeNumberComponent()
 	{
+		m_numberbox.removeMouseListener(this);
 		m_numberbox.removeChangeListener(this);
 	}
 	
@@ -54,19 +56,46 @@ namespace Kiwi
 		return m_numberbox.getValue();
 	}
 	
+	void AttributeNumberComponent::attributeChanged()
+	{
+		m_flonum = (m_attr->getStyle() == Attr::Style::NumberDouble);
+		m_numberbox.setFloatingPointStyle(m_flonum);
+	}
+	
 	void AttributeNumberComponent::refresh()
 	{
-		ElemVector state;
-		getAttributeValue(state);
+		// While dragging, the number box shows the value of the mouse and not the last committed one.
+		if (isInEditGesture())
+			return;
+		
+		double value;
 		
-		if (!state.empty())
+		// A recycled row mustn't keep the number of its previous attribute when the value can't be read.
+		if (! getAttributeValue(value))
 		{
-			m_numberbox.setValue((double)state[0], dontSendNotification);
+			value = 0.;
 		}
+		m_numberbox.setValue(value, dontSendNotification);
 	}
 	
 	void AttributeNumberComponent::changeListenerCallback(ChangeBroadcaster*)
 	{
-		setAttributeValue({ (m_flonum ? m_numberbox.getValue() : m_numberbox.getLongValue()) });
+		if (m_flonum)
+			setAttributeValue(m_numberbox.getValue());
+		else
+			setAttributeValue((long) m_numberbox.getLongValue());
+	}
+	
+	void AttributeNumberComponent::mouseDown (const MouseEvent& e)
+	{
+		// Only a drag of the number box is a gesture, a click on the rest of the row isn't.
+		if (isEnabled() && e.eventComponent == &m_numberbox)
+			beginEditGesture();
+	}
+	
+	void AttributeNumberComponent::mouseUp (const MouseEvent& e)
+	{
+		if (e.eventComponent == &m_numberbox)
+			endEditGesture();
 	}
 }
\ No newline at end of file
@@ -71,8 +71,15 @@ namespace Kiwi
 		void refresh();
 		/** @internal */
 		void changeListenerCallback (ChangeBroadcaster*) override;
+		/** @internal */
+		void mouseDown (const MouseEvent&) override;
+		/** @internal */
+		void mouseUp (const MouseEvent&) override;
 		
 	protected:
+		/** @internal */
+		void attributeChanged() override;
+		
 		/** The slider component being used in this component.
 		 Your subclass has access to this in case it needs to customise it in some way.
 		 */
@@ -29,112 +29,60 @@ namespace Kiwi
 	{
 	public:
 		CategoryComponent (const String& categoryTitle,
-						   const vector<shared_ptr<AttributeComponent>>& newAttributes,
+						   Attr::sManager manager,
+						   const vector<sAttr>& attributes,
 						   const bool categoryIsOpen_)
 		: Component (categoryTitle),
+		m_manager (manager),
+		m_attributes (attributes),
 		m_title_height (categoryTitle.isNotEmpty() ? 22 : 0),
-		m_category_is_open (categoryIsOpen_)
+		m_category_is_open (categoryIsOpen_),
+		m_header_scale (0.f),
+		m_header_open (false),
+		m_header_over (false)
 		{
-			m_attribute_comps = newAttributes;
-			
-			for (int i = m_attribute_comps.size(); --i >= 0;)
-			{
-				addAndMakeVisible (m_attribute_comps[i].get());
-				m_attribute_comps[i]->refresh();
-			}
-		}
-		
-		~CategoryComponent()
-		{
-			m_attribute_comps.clear();
+			;
 		}
 		
 		void paint (Graphics& g) override
 		{
 			if (m_title_height > 0)
 			{
-				const juce::Rectangle<int> titleRect = getLocalBounds().withHeight(m_title_height);
-				
-				//@see drawPropertyPanelCategoryHeader
-				const float buttonSize = m_title_height * 0.75f;
-				const float buttonIndent = (m_title_height - buttonSize) * 0.5f;
+				// The header is rendered once in an image, scrolling the panel only draws the image.
+				const float scale	= g.getInternalContext().getPhysicalPixelScaleFactor();
+				const bool over		= isMouseOver();
 				
-				//@see drawConcertinaPanelHeader
-				const Colour bkg (Colours::grey);
-				g.setGradientFill (ColourGradient (Colours::white.withAlpha (0.4f), 0, (float) titleRect.getY(),
-												   Colours::darkgrey.withAlpha (0.1f), 0, (float) titleRect.getBottom(), false));
-				g.fillAll();
-				
-				g.setColour (bkg.contrasting(0.5).withAlpha (0.1f));
-				g.fillRect (titleRect.withHeight (1));
-				g.fillRect (titleRect.withTop (titleRect.getBottom() - 1));
-				
-				const int textX = (int) (buttonIndent * 2.0f + buttonSize + 2.0f);
-				
-				g.setColour (bkg.contrasting());
-				g.setFont (juce::Font(titleRect.getHeight() * 0.6f).boldened());
-				g.drawFittedText(getName(), textX, 0, getWidth() - textX - 4, m_title_height, Justification::centredLeft, 1);
-				
-				//@see drawTreeviewPlusMinusBox
-				const juce::Rectangle<float> plusRect = juce::Rectangle<float>(buttonIndent, buttonIndent, buttonSize, buttonSize);
+				if (m_header.isNull() || m_header_scale != scale || m_header_open != isOpen() || m_header_over != over)
+				{
+					renderHeader (scale, over);
+				}
 				
-                juce::Path p;
-				p.addTriangle (0.0f, 0.0f, 1.0f, isOpen() ? 0.0f : 0.5f, isOpen() ? 0.5f : 0.0f, 1.0f);
-				g.setColour (Colours::white.contrasting().withAlpha (isMouseOver() ? 0.5f : 0.3f));
-				g.fillPath (p, p.getTransformToScaleToFit (plusRect.reduced (2, plusRect.getHeight() / 4), true));
+				g.drawImage (m_header, 0, 0, getWidth(), m_title_height, 0, 0, m_header.getWidth(), m_header.getHeight());
 			}
 		}
 		
 		void resized() override
 		{
-			int y = m_title_height;
-			
-			for (int i = 0; i < m_attribute_comps.size(); ++i)
-			{
-				shared_ptr<AttributeComponent> const comp = m_attribute_comps[i];
-				comp->setBounds (1, y, getWidth() - 2, comp->getPreferredHeight());
-				y = comp->getBottom();
-			}
+			m_header = Image();
 		}
 		
-		int getPreferredHeight() const
+		void setContent (Attr::sManager manager, const vector<sAttr>& attributes)
 		{
-			int y = m_title_height;
-			
-			if (isOpen())
-			{
-				for (int i = m_attribute_comps.size(); --i >= 0;)
-					y += m_attribute_comps[i]->getPreferredHeight();
-			}
-			
-			return y;
+			m_manager		= manager;
+			m_attributes	= attributes;
 		}
 		
-		void setOpen (const bool open)
-		{
-			if (m_category_is_open != open)
-			{
-				m_category_is_open = open;
-				
-				for (int i = m_attribute_comps.size(); --i >= 0;)
-					m_attribute_comps[i]->setVisible (open);
-				
-				if (AttributePanel* const pp = findParentComponentOfClass<AttributePanel>())
-					pp->resized();
-			}
-		}
+		int getTitleHeight() const noexcept						{ return m_title_height; }
+		Attr::sManager getManager() const noexcept				{ return m_manager; }
+		const vector<sAttr>& getAttributes() const noexcept		{ return m_attributes; }
+		
+		void setOpen (const bool open);
 		
 		bool isOpen() const
 		{
 			return m_category_is_open;
 		}
 		
-		void refreshAll() const
-		{
-			for (int i = m_attribute_comps.size(); --i >= 0;)
-				m_attribute_comps[i]->refresh();
-		}
-		
 		void mouseUp (const MouseEvent& e) override
 		{
 			if (e.getMouseDownX() < m_title_height
@@ -153,9 +101,55 @@ namespace Kiwi
 		}
 		
 	private:
-		vector<shared_ptr<AttributeComponent>>	m_attribute_comps;
+		Attr::sManager							m_manager;
+		vector<sAttr>							m_attributes;
 		int										m_title_height;
 		bool									m_category_is_open;
+		Image									m_header;
+		float									m_header_scale;
+		bool									m_header_open;
+		bool									m_header_over;
+		
+		void renderHeader (const float scale, const bool over)
+		{
+			m_header_scale	= scale;
+			m_header_open	= isOpen();
+			m_header_over	= over;
+			m_header		= Image (Image::ARGB, jmax (1, roundToInt (getWidth() * scale)), jmax (1, roundToInt (m_title_height * scale)), true);
+			
+			Graphics g (m_header);
+			g.addTransform (AffineTransform::scale (scale));
+			
+			const juce::Rectangle<int> titleRect (0, 0, getWidth(), m_title_height);
+			
+			//@see drawPropertyPanelCategoryHeader
+			const float buttonSize = m_title_height * 0.75f;
+			const float buttonIndent = (m_title_height - buttonSize) * 0.5f;
+			
+			//@see drawConcertinaPanelHeader
+			const Colour bkg (Colours::grey);
+			g.setGradientFill (ColourGradient (Colours::white.withAlpha (0.4f), 0, (float) titleRect.getY(),
+											   Colours::darkgrey.withAlpha (0.1f), 0, (float) titleRect.getBottom(), false));
+			g.fillRect (titleRect);
+			
+			g.setColour (bkg.contrasting(0.5).withAlpha (0.1f));
+			g.fillRect (titleRect.withHeight (1));
+			g.fillRect (titleRect.withTop (titleRect.getBottom() - 1));
+			
+			const int textX = (int) (buttonIndent * 2.0f + buttonSize + 2.0f);
+			
+			g.setColour (bkg.contrasting());
+			g.setFont (juce::Font(titleRect.getHeight() * 0.6f).boldened());
+			g.drawFittedText(getName(), textX, 0, getWidth() - textX - 4, m_title_height, Justification::centredLeft, 1);
+			
+			//@see drawTreeviewPlusMinusBox
+			const juce::Rectangle<float> plusRect = juce::Rectangle<float>(buttonIndent, buttonIndent, buttonSize, buttonSize);
+			
+			juce::Path p;
+			p.addTriangle (0.0f, 0.0f, 1.0f, isOpen() ? 0.0f : 0.5f, isOpen() ? 0.5f : 0.0f, 1.0f);
+			g.setColour (Colours::white.contrasting().withAlpha (over ? 0.5f : 0.3f));
+			g.fillPath (p, p.getTransformToScaleToFit (plusRect.reduced (2, plusRect.getHeight() / 4), true));
+		}
 		
 		JUCE_DECLARE_NON_COPYABLE (CategoryComponent)
 	};
@@ -164,7 +158,7 @@ namespace Kiwi
 	class AttributePanel::AttributeHolderComponent  : public Component
 	{
 	public:
-		AttributeHolderComponent() {}
+		AttributeHolderComponent (AttributePanel& owner) : m_owner (owner), m_matches_dirty (false) {}
 		
 		~AttributeHolderComponent()
 		{
@@ -175,47 +169,370 @@ namespace Kiwi
 		
 		void updateLayout (int width)
 		{
+			// Only the headers are components, the rows of the attributes are positions.
 			int y = 0;
+			m_rows.clear();
 			
-			for (int i = 0; i < m_categories.size(); ++i)
+			if (! m_filter.empty())
 			{
-				shared_ptr<CategoryComponent> const category = m_categories[i];
+				// The search shows a flat list of the matching attributes without the headers.
+				if (m_matches_dirty)
+					updateMatches();
+				
+				for (int i = 0; i < m_categories.size(); ++i)
+					m_categories[i]->setVisible (false);
 				
-				category->setBounds (0, y, width, category->getPreferredHeight());
-				y = category->getBottom();
+				for (Key const& key : m_matches)
+				{
+					const int height = m_owner.getAttributeHeight (m_categories[int(key.first)]->getAttributes()[key.second]);
+					m_rows.push_back ({key.first, key.second, y, height});
+					y += height;
+				}
+			}
+			else
+			{
+				for (int i = 0; i < m_categories.size(); ++i)
+				{
+					CategoryComponent* const category = m_categories[i];
+					category->setVisible (true);
+					category->setBounds (0, y, width, category->getTitleHeight());
+					y = category->getBottom();
+					
+					if (category->isOpen())
+					{
+						const vector<sAttr>& attrs = category->getAttributes();
+						for (size_t j = 0; j < attrs.size(); ++j)
+						{
+							const int height = m_owner.getAttributeHeight (attrs[j]);
+							m_rows.push_back ({size_t(i), j, y, height});
+							y += height;
+						}
+					}
+				}
 			}
 			
 			setSize (width, y);
+			updateVisibleRows();
+			flushPool();
 			repaint();
 		}
 		
+		void setViewArea (const juce::Rectangle<int>& area)
+		{
+			if (m_view_area != area)
+			{
+				m_view_area = area;
+				updateVisibleRows();
+			}
+		}
+		
 		void refreshAll() const
 		{
-			for (int i = 0; i < m_categories.size(); ++i)
-				m_categories[i]->refreshAll();
+			for (auto const& visible : m_visible)
+				visible.second.component->refresh();
+		}
+		
+		void refreshAttr (sAttr attr) const
+		{
+			for (auto const& visible : m_visible)
+			{
+				if (m_categories[int(visible.first.first)]->getAttributes()[visible.first.second] == attr)
+					visible.second.component->refresh();
+			}
 		}
 		
 		void clear()
 		{
+			for (auto const& visible : m_visible)
+				release (visible.second);
+			
+			m_visible.clear();
+			m_rows.clear();
 			m_categories.clear();
+			m_index.clear();
+			m_matches_dirty = true;
+		}
+		
+		void addCategory (CategoryComponent* newCategory)
+		{
+			m_categories.add (newCategory);
+			addAndMakeVisible (newCategory, 0);
+			m_index.clear();
+			m_matches_dirty = true;
 		}
 		
-		void addCategory (shared_ptr<CategoryComponent> newCategory)
+		bool setFilter (const String& text)
 		{
-			m_categories.push_back(newCategory);
-			addAndMakeVisible(newCategory.get(), 0);
+			const string filter = text.trim().toLowerCase().toStdString();
+			if (filter != m_filter)
+			{
+				m_filter = filter;
+				m_matches_dirty = true;
+				return true;
+			}
+			return false;
+		}
+		
+		void setCategories (Attr::sManager manager, const vector<Category>& categories)
+		{
+			// The visible components go back to the pool but stay bound and in place,
+			// so the next layout only rebinds them.
+			for (auto const& visible : m_visible)
+				m_pool[visible.second.style].push_back (visible.second.component);
+			
+			m_visible.clear();
+			m_rows.clear();
+			
+			OwnedArray<CategoryComponent> previous;
+			previous.swapWith (m_categories);
+			
+			for (auto const& content : categories)
+			{
+				CategoryComponent* category = nullptr;
+				for (int i = 0; i < previous.size(); ++i)
+				{
+					if (previous[i]->getName() == content.name)
+					{
+						category = previous.removeAndReturn (i);
+						break;
+					}
+				}
+				
+				if (category)
+				{
+					category->setContent (manager, content.attributes);
+					m_categories.add (category);
+				}
+				else
+				{
+					addCategory (new CategoryComponent (content.name, manager, content.attributes, true));
+				}
+			}
+			
+			m_index.clear();
+			m_matches_dirty = true;
+		}
+		
+		//! Detaches the pooled components that haven't been reused by the layout.
+		void flushPool()
+		{
+			for (auto& pool : m_pool)
+			{
+				for (auto const& component : pool.second)
+				{
+					if (component->getParentComponent() == this)
+					{
+						removeChildComponent (component.get());
+						component->setAttribute (sAttr(), Attr::sManager());
+					}
+				}
+			}
+		}
+		
+		void setCategoryEnabled (CategoryComponent* category, const bool enabled)
+		{
+			category->setEnabled (enabled);
+			
+			for (auto const& visible : m_visible)
+			{
+				if (m_categories[int(visible.first.first)] == category)
+					visible.second.component->setEnabled (enabled && ! category->getAttributes()[visible.first.second]->isDisabled());
+			}
 		}
 		
 		int getNumCategories() const noexcept								{ return m_categories.size(); }
-		shared_ptr<CategoryComponent> getCategory (const int index) const	{ return m_categories[index]; }
+		CategoryComponent* getCategory (const int index) const				{ return m_categories[index]; }
 		
 	private:
 		
-		vector<shared_ptr<CategoryComponent>>					m_categories;
+		class Row
+		{
+		public:
+			size_t	category;
+			size_t	attr;
+			int		y;
+			int		height;
+		};
+		
+		class Slot
+		{
+		public:
+			Attr::Style						style;
+			shared_ptr<AttributeComponent>	component;
+		};
+		
+		typedef pair<size_t, size_t> Key;
+		
+		//! An entry of the search index, the lower case name of an attribute and its row.
+		class Entry
+		{
+		public:
+			string	name;
+			Key		key;
+			
+			bool operator< (Entry const& other) const noexcept
+			{
+				return name < other.name;
+			}
+		};
+		
+		//! Sorts the names of the attributes, the attributes that start with a prefix are then a contiguous range.
+		void updateIndex()
+		{
+			m_index.clear();
+			for (int i = 0; i < m_categories.size(); ++i)
+			{
+				const vector<sAttr>& attrs = m_categories[i]->getAttributes();
+				for (size_t j = 0; j < attrs.size(); ++j)
+				{
+					string name = attrs[j]->getName()->getName();
+					transform (name.begin(), name.end(), name.begin(), ::tolower);
+					m_index.push_back ({name, Key (size_t(i), j)});
+				}
+			}
+			sort (m_index.begin(), m_index.end());
+		}
+		
+		void updateMatches()
+		{
+			if (m_index.empty())
+				updateIndex();
+			
+			m_matches.clear();
+			auto it = lower_bound (m_index.begin(), m_index.end(), Entry {m_filter, Key()});
+			for (; it != m_index.end() && it->name.compare (0, m_filter.size(), m_filter) == 0; ++it)
+				m_matches.push_back (it->key);
+			
+			// The matching attributes keep the order of the panel.
+			sort (m_matches.begin(), m_matches.end());
+			m_matches_dirty = false;
+		}
+		
+		//! Creates the components of the rows that became visible and recycles the others.
+		void updateVisibleRows()
+		{
+			auto row = m_rows.end(), last = m_rows.end();
+			if (! m_rows.empty() && ! m_view_area.isEmpty())
+			{
+				row = lower_bound (m_rows.begin(), m_rows.end(), m_view_area.getY(), [] (Row const& row, const int y)
+				{
+					return row.y + row.height <= y;
+				});
+				
+				last = lower_bound (row, m_rows.end(), m_view_area.getBottom(), [] (Row const& row, const int y)
+				{
+					return row.y < y;
+				});
+			}
+			
+			// The rows and the visible slots are both sorted by key, so the rows of the view are
+			// merged with the slots and the slots that aren't met are outside of the view.
+			auto it = m_visible.begin();
+			for (; row != last; ++row)
+			{
+				const Key key (row->category, row->attr);
+				while (it != m_visible.end() && it->first < key)
+				{
+					release (it->second);
+					it = m_visible.erase (it);
+				}
+				
+				if (it == m_visible.end() || key < it->first)
+				{
+					Slot slot = acquire (row->category, row->attr);
+					if (! slot.component)
+						continue;
+					
+					it = m_visible.emplace_hint (it, key, slot);
+				}
+				
+				it->second.component->setBounds (1, row->y, getWidth() - 2, row->height);
+				++it;
+			}
+			
+			while (it != m_visible.end())
+			{
+				release (it->second);
+				it = m_visible.erase (it);
+			}
+		}
+		
+		Slot acquire (const size_t index, const size_t attrIndex)
+		{
+			CategoryComponent* const category = m_categories[int(index)];
+			sAttr const& attr = category->getAttributes()[attrIndex];
+			
+			Slot slot;
+			slot.style = attr->getStyle();
+			
+			vector<shared_ptr<AttributeComponent>>& pool = m_pool[slot.style];
+			if (! pool.empty())
+			{
+				slot.component = pool.back();
+				pool.pop_back();
+				slot.component->setAttribute (attr, category->getManager());
+			}
+			else
+			{
+				slot.component = m_owner.createAttributeComponent (category->getManager(), attr);
+			}
+			
+			if (slot.component)
+			{
+				slot.component->setEnabled (category->isEnabled() && ! attr->isDisabled());
+				addAndMakeVisible (slot.component.get());
+			}
+			return slot;
+		}
+		
+		void release (Slot const& slot)
+		{
+			removeChildComponent (slot.component.get());
+			slot.component->setAttribute (sAttr(), Attr::sManager());
+			m_pool[slot.style].push_back (slot.component);
+		}
+		
+		AttributePanel&											m_owner;
+		OwnedArray<CategoryComponent>							m_categories;
+		vector<Row>												m_rows;
+		map<Key, Slot>											m_visible;
+		map<Attr::Style, vector<shared_ptr<AttributeComponent>>>	m_pool;
+		juce::Rectangle<int>									m_view_area;
+		vector<Entry>											m_index;
+		vector<Key>												m_matches;
+		string													m_filter;
+		bool													m_matches_dirty;
 		
 		JUCE_DECLARE_NON_COPYABLE (AttributeHolderComponent)
 	};
 	
+	void AttributePanel::CategoryComponent::setOpen (const bool open)
+	{
+		if (m_category_is_open != open)
+		{
+			m_category_is_open = open;
+			repaint();
+			
+			if (AttributePanel* const pp = findParentComponentOfClass<AttributePanel>())
+				pp->resized();
+		}
+	}
+	
+	//==============================================================================
+	class AttributePanel::PanelViewport  : public Viewport
+	{
+	public:
+		PanelViewport (AttributeHolderComponent*& holder) : m_holder (holder) {}
+		
+		void visibleAreaChanged (const juce::Rectangle<int>& newVisibleArea) override
+		{
+			if (m_holder)
+				m_holder->setViewArea (newVisibleArea);
+		}
+		
+	private:
+		AttributeHolderComponent*&	m_holder;
+	};
 	
 	//==============================================================================
 	AttributePanel::AttributePanel()
@@ -230,15 +547,24 @@ namespace Kiwi
 	
 	void AttributePanel::init()
 	{
-		m_viewport.setScrollBarThickness(12.);
+		m_attribute_holder_comp = nullptr;
+		m_viewport = new PanelViewport (m_attribute_holder_comp);
+		m_viewport->setScrollBarThickness(12.);
 		addAndMakeVisible (m_viewport);
-		m_viewport.setViewedComponent (m_attribute_holder_comp = new AttributeHolderComponent());
-		m_viewport.setFocusContainer (true);
+		m_viewport->setViewedComponent (m_attribute_holder_comp = new AttributeHolderComponent (*this));
+		m_viewport->setFocusContainer (true);
+		
+		m_search = new TextEditor ("search");
+		m_search->setTextToShowWhenEmpty ("Search", Colours::grey);
+		m_search->addListener (this);
+		addAndMakeVisible (m_search);
 	}
 	
 	AttributePanel::~AttributePanel()
 	{
 		clear();
+		m_search = nullptr;
+		m_viewport = nullptr;
 	}
 	
 	//==============================================================================
@@ -248,10 +574,48 @@ namespace Kiwi
 	
 	void AttributePanel::resized()
 	{
-		m_viewport.setBounds (getLocalBounds());
+		juce::Rectangle<int> bounds (getLocalBounds());
+		m_search->setBounds (bounds.removeFromTop (24).reduced (2));
+		m_viewport->setBounds (bounds);
 		updateAttrHolderLayout();
 	}
 	
+	//==============================================================================
+	void AttributePanel::setSearchText (const String& text)
+	{
+		if (m_search->getText() != text)
+			m_search->setText (text, false);
+		
+		if (m_attribute_holder_comp->setFilter (text))
+			updateAttrHolderLayout();
+	}
+	
+	String AttributePanel::getSearchText() const
+	{
+		return m_search->getText();
+	}
+	
+	void AttributePanel::textEditorTextChanged (TextEditor& editor)
+	{
+		setSearchText (editor.getText());
+	}
+	
+	void AttributePanel::textEditorEscapeKeyPressed (TextEditor&)
+	{
+		setSearchText (String::empty);
+	}
+	
+	//==============================================================================
+	shared_ptr<AttributeComponent> AttributePanel::createAttributeComponent (Attr::sManager manager, sAttr attr)
+	{
+		return nullptr;
+	}
+	
+	int AttributePanel::getAttributeHeight (sAttr attr) const
+	{
+		return AttributeComponent::defaultHeight;
+	}
+	
 	//==============================================================================
 	void AttributePanel::clear()
 	{
@@ -273,24 +637,30 @@ namespace Kiwi
 	}
 	
 	void AttributePanel::addCategory(const String& categoryName,
-									 const vector<shared_ptr<AttributeComponent>>& newAttributes,
+									 Attr::sManager manager,
+									 const vector<sAttr>& attributes,
 									 bool shouldBeOpen)
 	{
 		if (isEmpty())
 			repaint();
 		
-		m_attribute_holder_comp->addCategory (make_shared<CategoryComponent>(categoryName, newAttributes, shouldBeOpen));
-
-		//m_attribute_holder_comp->addCategory (new CategoryComponent (categoryName, newAttributes, shouldBeOpen));
+		m_attribute_holder_comp->addCategory (new CategoryComponent (categoryName, manager, attributes, shouldBeOpen));
+		updateAttrHolderLayout();
+	}
+	
+	void AttributePanel::setCategories (Attr::sManager manager, const vector<Category>& categories)
+	{
+		m_attribute_holder_comp->setCategories (manager, categories);
 		updateAttrHolderLayout();
+		repaint();
 	}
 	
 	void AttributePanel::updateAttrHolderLayout() const
 	{
-		const int maxWidth = m_viewport.getMaximumVisibleWidth();
+		const int maxWidth = m_viewport->getMaximumVisibleWidth();
 		m_attribute_holder_comp->updateLayout (maxWidth);
 		
-		const int newMaxWidth = m_viewport.getMaximumVisibleWidth();
+		const int newMaxWidth = m_viewport->getMaximumVisibleWidth();
 		if (maxWidth != newMaxWidth)
 		{
 			// need to do this twice because of scrollbars changing the size, etc.
@@ -305,7 +675,17 @@ namespace Kiwi
 	
 	void AttributePanel::refreshAttr(sAttr attr) const
 	{
-		
+		m_attribute_holder_comp->refreshAttr (attr);
+	}
+	
+	void AttributePanel::setAttributeValue (Attr::sManager manager, sAttr attr, ElemVector const& elements)
+	{
+		/*
+		if (manager && attr)
+		{
+			manager->setAttributeValue(attr->getName(), elements);
+		}
+		*/
 	}
 	
 	//==============================================================================
@@ -315,7 +695,7 @@ namespace Kiwi
 		
 		for (int i = 0; i < m_attribute_holder_comp->getNumCategories(); ++i)
 		{
-			shared_ptr<CategoryComponent> const category = m_attribute_holder_comp->getCategory (i);
+			CategoryComponent* const category = m_attribute_holder_comp->getCategory (i);
 			
 			if (category->getName().isNotEmpty())
 				s.add (category->getName());
@@ -330,7 +710,7 @@ namespace Kiwi
 		
 		for (int i = 0; i < m_attribute_holder_comp->getNumCategories(); ++i)
 		{
-			shared_ptr<CategoryComponent> const category = m_attribute_holder_comp->getCategory (i);
+			CategoryComponent* const category = m_attribute_holder_comp->getCategory (i);
 			
 			if (category->getName().isNotEmpty())
 			{
@@ -350,7 +730,7 @@ namespace Kiwi
 		
 		for (int i = 0; i < m_attribute_holder_comp->getNumCategories(); ++i)
 		{
-			shared_ptr<CategoryComponent> const category = m_attribute_holder_comp->getCategory (i);
+			CategoryComponent* const category = m_attribute_holder_comp->getCategory (i);
 			
 			if (category->getName().isNotEmpty())
 			{
@@ -371,13 +751,13 @@ namespace Kiwi
 		
 		for (int i = 0; i < m_attribute_holder_comp->getNumCategories(); ++i)
 		{
-			shared_ptr<CategoryComponent> const category = m_attribute_holder_comp->getCategory (i);
+			CategoryComponent* const category = m_attribute_holder_comp->getCategory (i);
 			
 			if (category->getName().isNotEmpty())
 			{
 				if (index == categoryIndex)
 				{
-					category->setEnabled (shouldBeEnabled);
+					m_attribute_holder_comp->setCategoryEnabled (category, shouldBeEnabled);
 					break;
 				}
 				
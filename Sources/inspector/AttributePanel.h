@@ -37,14 +37,29 @@ namespace Kiwi
 	 This panel displays a list of AttributeComponents, and allows them to be organised
 	 into collapsible categorys.
 	 
-	 To use, simply create one of these and add your attributes to it with addAttribute()
-	 or addCategory().
+	 To use, simply create one of these and add your attributes to it with addCategory().
+	 
+	 The panel only holds a list of rows, the components are created for the visible rows
+	 with createAttributeComponent() and are recycled by style when they scroll out of view,
+	 so the number of components doesn't depend on the number of attributes.
+	 
+	 The search field at the top of the panel shows a flat list of the attributes whose
+	 name starts with the text, the names are looked up in a sorted index of the panel.
 	 
 	 @see AttributeComponent
 	 */
-	class AttributePanel  : public Component
+	class AttributePanel  : public Component, private TextEditor::Listener
 	{
 	public:
+		//==============================================================================
+		/** The content of a category: its name and its attributes. */
+		class Category
+		{
+		public:
+			String			name;
+			vector<sAttr>	attributes;
+		};
+		
 		//==============================================================================
 		/** Creates an empty attribute panel. */
 		AttributePanel();
@@ -67,26 +82,49 @@ namespace Kiwi
 		 */
 		void addAttributes (const Array <AttributeComponent*>& newAttributeComponents);
 		
-		/** Adds a set of attribute components to the panel.
+		/** Adds a set of attributes to the panel.
 		 
-		 These components are added at the bottom of the list, under a category heading with
+		 These attributes are added at the bottom of the list, under a category heading with
 		 a plus/minus button that allows it to be opened and closed.
 		 
-		 The components in the list will be owned by this object and will be automatically
-		 deleted later on when no longer needed.
-		 
-		 To add attribute components without them being in a category, use addAttributes().
+		 No component is created here, the components are created or recycled when the rows
+		 of the attributes become visible.
 		 */
 		void addCategory (const String& categoryName,
-						  const vector<shared_ptr<AttributeComponent>>& newAttributeComponents,
+						  Attr::sManager manager,
+						  const vector<sAttr>& attributes,
 						  bool shouldCategoryInitiallyBeOpen = true);
 		
+		/** Replaces the categories of the panel by the categories of another manager.
+		 
+		 The new categories are compared with the ones that are shown: a category that keeps
+		 its name keeps its header and its open state, and the visible components are rebound
+		 to the new attributes of the same style instead of being destroyed and created again.
+		 */
+		void setCategories (Attr::sManager manager, const vector<Category>& categories);
+		
 		/** Calls the refresh() method of all AttributeComponents in the panel */
 		void refreshAll() const;
 		
 		/** Calls the refresh() method of the AttributeComponent in the panel that is a view of this specific attribute */
 		void refreshAttr(sAttr attr) const;
 		
+		/** Sets the value of an attribute edited by one of the components of the panel.
+		 
+		 The components don't write to their manager themselves, they call this method so
+		 a panel that shows several managers can apply the value to all of them. The default
+		 implementation sets the value of the attribute of the manager.
+		 */
+		virtual void setAttributeValue (Attr::sManager manager, sAttr attr, ElemVector const& elements);
+		
+		/** Shows only the attributes whose name starts with a text.
+		 The search is case insensitive, an empty text shows all the categories.
+		 */
+		void setSearchText (const String& text);
+		
+		/** Returns the text of the search field. */
+		String getSearchText() const;
+		
 		/** Returns true if the panel contains no attribute. */
 		bool isEmpty() const;
 		
@@ -122,14 +160,35 @@ namespace Kiwi
 		/** @internal */
 		void resized() override;
 		
+	protected:
+		//==============================================================================
+		/** Creates the component that displays an attribute.
+		 
+		 The panel calls this method when the row of an attribute becomes visible and no
+		 component of the same style can be recycled. The default implementation returns
+		 nullptr and the row stays empty.
+		 */
+		virtual shared_ptr<AttributeComponent> createAttributeComponent (Attr::sManager manager, sAttr attr);
+		
+		/** Returns the height of the row of an attribute.
+		 
+		 The height only depends on the attribute so the layout of the panel can be computed
+		 without creating the components.
+		 */
+		virtual int getAttributeHeight (sAttr attr) const;
+		
 	private:
 		class CategoryComponent;
 		class AttributeHolderComponent;
+		class PanelViewport;
 		
-		Viewport										m_viewport;
+		ScopedPointer<PanelViewport>					m_viewport;
 		AttributeHolderComponent*						m_attribute_holder_comp;
+		ScopedPointer<TextEditor>						m_search;
 		
 		void init();
+		void textEditorTextChanged (TextEditor&) override;
+		void textEditorEscapeKeyPressed (TextEditor&) override;
 		void updateAttrHolderLayout() const;
 		
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AttributePanel)
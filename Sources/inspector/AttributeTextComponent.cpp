@@ -22,6 +22,7 @@
  */
 
 #include "AttributeTextComponent.h"
+#include "../jAtomParser.h"
 
 namespace Kiwi
 {
@@ -106,10 +107,8 @@ namespace Kiwi
 		ElemVector value;
 		getAttributeValue(value);
 		
-		if (!value.empty())
-		{
-			textEditor->setText(toString(value), dontSendNotification);
-		}
+		// A recycled row mustn't keep the text of its previous attribute when the value can't be read.
+		textEditor->setText(value.empty() ? String::empty : String(toString(value)), dontSendNotification);
 	}
 	
 	void AttributeTextComponent::enablementChanged()
@@ -119,34 +118,11 @@ namespace Kiwi
 		repaint();
 	}
 	
-	void fromText(ElemVector& elements, string const& text)
-	{
-		string word;
-		istringstream iss(text);
-		while(iss >> word)
-		{
-			if(isdigit(word[0]))
-			{
-				if(word.find('.') != string::npos)
-				{
-					elements.push_back(atof(word.c_str()));
-				}
-				else
-				{
-					elements.push_back(atol(word.c_str()));
-				}
-			}
-			else
-			{
-				elements.push_back(Tag::create(word));
-			}
-		}
-	}
-	
 	void AttributeTextComponent::textWasEdited()
 	{
 		ElemVector elements;
-		fromText(elements, textEditor->getText().toStdString());
+		const String text = textEditor->getText();
+		jAtomParser::parse(text.toRawUTF8(), text.getNumBytesAsUTF8(), elements);
 		
 		setAttributeValue(elements);
 	}
@@ -34,148 +34,258 @@ namespace Kiwi
 	//								ATTRIBUTE PANEL COMPONENT                           //
 	// ================================================================================ //
 	
-	AttributeViewer::AttributeViewer()
+	AttributeViewer::AttributeViewer() : m_batch_thread(nullptr)
 	{
 		//rebuildProperties();
 	}
 	
 	AttributeViewer::~AttributeViewer()
 	{
-		cout << "Panel delete" << endl;
+		stopTimer();
 		//setAttributeManagerToWatch(nullptr); // is it safe to note unbind the listener
 	}
 	
 	void AttributeViewer::setAttributeManagerToWatch(Attr::sManager attrsManager)
 	{
-		if (m_attr_manager != attrsManager)
+		if (attrsManager)
 		{
-			if (m_attr_manager)
+			setAttributeManagersToWatch({attrsManager});
+		}
+		else
+		{
+			setAttributeManagersToWatch({});
+		}
+	}
+	
+	void AttributeViewer::setAttributeManagersToWatch(vector<Attr::sManager> const& attrsManagers)
+	{
+		if (m_attr_managers != attrsManagers)
+		{
+			for (auto const& manager : m_attr_managers)
             {
-                m_attr_manager->unbind(shared_from_this());
+                manager->unbind(shared_from_this());
             }
 			
-			m_attr_manager = attrsManager;
+			m_attr_managers = attrsManagers;
+			m_attr_manager	= m_attr_managers.empty() ? nullptr : m_attr_managers.front();
+			
+			{
+				const ScopedLock lock(m_dirty_lock);
+				m_dirty.clear();
+				m_shared.clear();
+			}
 			
 			if (m_attr_manager)
 			{
-				m_attr_manager->bind(shared_from_this());
+				for (auto const& manager : m_attr_managers)
+				{
+					manager->bind(shared_from_this());
+				}
 				rebuildProperties();
 			}
+			else
+			{
+				stopTimer();
+				clear();
+			}
 		}
 	}
 	
 	void AttributeViewer::notify(shared_ptr<Attr::Manager> manager, sAttr attr, Attr::Notification type)
 	{
-		if (manager == m_attr_manager)
+		if (type == Attr::Notification::ValueChanged)
+		{
+			// Only the notifications of the batch itself are coalesced, the changes of the other threads are shown.
+			const ScopedLock lock(m_dirty_lock);
+			if (attr->getName() != m_batch || Thread::getCurrentThreadId() != m_batch_thread)
+			{
+				markDirty(attr->getName());
+			}
+		}
+	}
+	
+	void AttributeViewer::markDirty(sTag name)
+	{
+		// The change of any watched manager refreshes the row of the first manager's attribute.
+		auto it = m_shared.find(name);
+		if (it != m_shared.end())
 		{
-			if (type == Attr::Notification::ValueChanged)
+			m_dirty.insert(it->second);
+			if (!isTimerRunning())
 			{
-				cout << "attrViewer : attr changed" << endl;
-				refreshAttr(attr);
+				startTimer(1000 / 60);
 			}
 		}
 	}
 	
+	void AttributeViewer::setAttributeValue(Attr::sManager manager, sAttr attr, ElemVector const& elements)
+	{
+		if (manager == m_attr_manager && m_attr_managers.size() > 1)
+		{
+			// The row is marked once when all the managers are written.
+			const ScopedLock batch(m_batch_lock);
+			{
+				const ScopedLock lock(m_dirty_lock);
+				m_batch			= attr->getName();
+				m_batch_thread	= Thread::getCurrentThreadId();
+			}
+			
+			for (auto const& watched : m_attr_managers)
+			{
+				AttributePanel::setAttributeValue(watched, attr, elements);
+			}
+			
+			const ScopedLock lock(m_dirty_lock);
+			m_batch			= nullptr;
+			m_batch_thread	= nullptr;
+			markDirty(attr->getName());
+		}
+		else
+		{
+			AttributePanel::setAttributeValue(manager, attr, elements);
+		}
+	}
+	
+	void AttributeViewer::timerCallback()
+	{
+		set<sAttr> dirty;
+		{
+			const ScopedLock lock(m_dirty_lock);
+			dirty.swap(m_dirty);
+			stopTimer();
+		}
+		
+		for (auto const& attr : dirty)
+		{
+			refreshAttr(attr);
+		}
+	}
+	
 	void AttributeViewer::resized()
 	{
 		AttributePanel::resized();
 	}
 	
+	static void getVisibleAttributes(Attr::sManager manager, map<sTag, sAttr>& attrs)
+	{
+		vector<sTag> names;
+		manager->getCategoriesNames(names, true);
+		
+		for (auto const& name : names)
+		{
+			vector<sAttr> category;
+			manager->getAttributesInCategory(name, category, true);
+			for (auto const& attr : category)
+			{
+				attrs[attr->getName()] = attr;
+			}
+		}
+	}
+	
 	void AttributeViewer::rebuildProperties()
 	{
-		vector<sTag>  categories;
-		vector<sAttr> attrs;
-		sTag  categoryName;
-		sAttr attr;
-		Attr::Style style;
-		vector<shared_ptr<AttributeComponent>> attrsComps;
+		vector<sTag>		names;
+		vector<Category>	categories;
+		map<sTag, sAttr>	shared;
 		
-		clear();
+		if (!m_attr_manager)
+			return;
+		
+		// The attributes of the other managers, an attribute is only shown if all of them have it with the same style.
+		vector<map<sTag, sAttr>> others(m_attr_managers.size() - 1);
+		for (size_t i = 1; i < m_attr_managers.size(); i++)
+		{
+			getVisibleAttributes(m_attr_managers[i], others[i - 1]);
+		}
 		
-		m_attr_manager->getCategoriesNames(categories, true);
+		m_attr_manager->getCategoriesNames(names, true);
 		
-		for (int i = 0; i < categories.size(); i++)
+		for (int i = 0; i < names.size(); i++)
 		{
-			attrsComps.clear();
+			vector<sAttr> attrs;
+			m_attr_manager->getAttributesInCategory(names[i], attrs, true);
 			
-			categoryName = categories[i];
-			m_attr_manager->getAttributesInCategory(categoryName, attrs, true);
-			
-			if (!attrs.empty())
+			Category category;
+			for (auto const& attr : attrs)
 			{
-				for (int j = 0; j < attrs.size(); j++)
+				bool common = true;
+				for (auto const& other : others)
 				{
-					attr = attrs[j];
-					style = attr->getStyle();
-					
-					switch (style)
+					auto it = other.find(attr->getName());
+					if (it == other.end() || it->second->getStyle() != attr->getStyle())
 					{
-						case Attr::Style::Toggle:
-						{
-							attrsComps.push_back(createBoolComponent(m_attr_manager, attr));
-							break;
-						}
-						case Attr::Style::NumberLong:
-						case Attr::Style::NumberDouble:
-						{
-							attrsComps.push_back(createNumberComponent(m_attr_manager, attr));
-							break;
-						}
-						case Attr::Style::Text:
-						{
-							attrsComps.push_back(createTextComponent(m_attr_manager, attr));
-							break;
-						}
-						case Attr::Style::List:
-						{
-							attrsComps.push_back(createTextComponent(m_attr_manager, attr));
-							break;
-						}
-						case Attr::Style::Enum:
-						{
-							attrsComps.push_back(createMenuComponent(m_attr_manager, attr));
-							break;
-						}
-						case Attr::Style::Color:
-						{
-							attrsComps.push_back(createColorComponent(m_attr_manager, attr));
-							break;
-						}
-						default:
-							break;
+						common = false;
+						break;
 					}
 				}
 				
-				addCategory(categoryName->getName(), attrsComps, true);
+				if (common)
+				{
+					category.attributes.push_back(attr);
+					shared[attr->getName()] = attr;
+				}
+			}
+			
+			if (!category.attributes.empty())
+			{
+				category.name = names[i]->getName();
+				categories.push_back(category);
 			}
 		}
 		
-		attrsComps.clear();
+		{
+			const ScopedLock lock(m_dirty_lock);
+			m_shared.swap(shared);
+		}
+		
+		// Only the differences with the previous manager are applied to the panel.
+		setCategories(m_attr_manager, categories);
+	}
+	
+	shared_ptr<AttributeComponent> AttributeViewer::createAttributeComponent(Attr::sManager manager, sAttr attr)
+	{
+		switch (attr->getStyle())
+		{
+			case Attr::Style::Toggle:
+				return createBoolComponent(manager, attr);
+			case Attr::Style::NumberLong:
+			case Attr::Style::NumberDouble:
+				return createNumberComponent(manager, attr);
+			case Attr::Style::Text:
+			case Attr::Style::List:
+				return createTextComponent(manager, attr);
+			case Attr::Style::Enum:
+				return createMenuComponent(manager, attr);
+			case Attr::Style::Color:
+				return createColorComponent(manager, attr);
+			default:
+				return nullptr;
+		}
 	}
 	
 	shared_ptr<AttributeComponent> AttributeViewer::createBoolComponent(Attr::sManager manager, sAttr attr)
 	{
-		return AttributeComponent::create<AttributeBoolComponent>(attr, m_attr_manager);
+		return AttributeComponent::create<AttributeBoolComponent>(attr, manager);
 	}
 	
 	shared_ptr<AttributeComponent> AttributeViewer::createNumberComponent(Attr::sManager manager, sAttr attr)
 	{
-		return AttributeComponent::create<AttributeNumberComponent>(attr, m_attr_manager, 0., 100., 0.1);
+		return AttributeComponent::create<AttributeNumberComponent>(attr, manager, 0., 100., 0.1);
 	}
 	
 	shared_ptr<AttributeComponent> AttributeViewer::createTextComponent(Attr::sManager manager, sAttr attr)
 	{
-		return AttributeComponent::create<AttributeTextComponent>(attr, m_attr_manager, 3000, false);
+		return AttributeComponent::create<AttributeTextComponent>(attr, manager, 3000, false);
 	}
 	
 	shared_ptr<AttributeComponent> AttributeViewer::createMenuComponent(Attr::sManager manager, sAttr attr)
 	{
-		return AttributeComponent::create<AttributeMenuComponent>(attr, m_attr_manager);
+		return AttributeComponent::create<AttributeMenuComponent>(attr, manager);
 	}
 	
 	shared_ptr<AttributeComponent> AttributeViewer::createColorComponent(Attr::sManager manager, sAttr attr)
 	{
-		return AttributeComponent::create<AttributeColorComponent>(attr, m_attr_manager);
+		return AttributeComponent::create<AttributeColorComponent>(attr, manager);
 	}
 	
 	// ================================================================================ //
@@ -204,22 +314,23 @@ namespace Kiwi
 		m_attr_viewer.reset();
     }
 	
+	void InspectorWindow::showViewer()
+	{
+		if (!m_attr_viewer)
+		{
+			m_attr_viewer = make_shared<AttributeViewer>();
+			m_attr_viewer->setBounds(getLocalBounds());
+			setContentNonOwned(m_attr_viewer.get(), true);
+		}
+	}
+	
 	void InspectorWindow::setPage(sPage page)
 	{
 		if (page)
 		{
-			if (!m_attr_viewer || (m_attr_viewer->getViewedManager() != page))
-			{
-				shared_ptr<AttributeViewer> viewer = AttributeViewer::create(page);
-				
-				if (viewer)
-				{
-					m_attr_viewer = viewer;
-					m_attr_viewer->setBounds(getLocalBounds());
-					setContentNonOwned(m_attr_viewer.get(), true);
-					setName("Page inspector");
-				}
-			}
+			showViewer();
+			m_attr_viewer->setAttributeManagerToWatch(page);
+			setName("Page inspector");
 		}
 	}
 	
@@ -227,31 +338,38 @@ namespace Kiwi
 	{
 		if (object)
 		{
-			if (!m_attr_viewer || (m_attr_viewer->getViewedManager() != object))
-			{
-				shared_ptr<AttributeViewer> viewer = AttributeViewer::create(object);
-				
-				if (viewer)
-				{
-					m_attr_viewer = viewer;
-					m_attr_viewer->setBounds(getLocalBounds());
-					setContentNonOwned(m_attr_viewer.get(), true);
-					string name = toString(object->getName());
-					if (name.empty())
-						name = "Object";
-					
-					setName(name + " inspector");
-				}
-			}
+			showViewer();
+			m_attr_viewer->setAttributeManagerToWatch(object);
+			string name = toString(object->getName());
+			if (name.empty())
+				name = "Object";
+			
+			setName(name + " inspector");
 		}
 		else
 		{
-			m_attr_viewer = sAttributeViewer();
-			setContentNonOwned(nullptr, true);
+			if (m_attr_viewer)
+			{
+				m_attr_viewer->setAttributeManagerToWatch(nullptr);
+			}
 			setName("Object inspector");
 		}
 	}
     
+	void InspectorWindow::setObjects(vector<sObject> const& objects)
+	{
+		if (objects.size() < 2)
+		{
+			setObject(objects.empty() ? sObject() : objects.front());
+		}
+		else
+		{
+			showViewer();
+			m_attr_viewer->setAttributeManagersToWatch(vector<Attr::sManager>(objects.begin(), objects.end()));
+			setName(to_string(objects.size()) + " objects inspector");
+		}
+	}
+	
     void InspectorWindow::closeButtonPressed()
     {
         setVisible(false);
@@ -34,21 +34,47 @@ namespace Kiwi
     // ================================================================================ //
 	
 	//! Display a set of attributes.
-	/** The attribute panel is a component that display a set of attributes
+	/** The attribute panel is a component that display a set of attributes.
+	 The notifications of the manager can come from any thread and at any rate, the viewer only
+	 marks the attributes as dirty and refreshes their components once per display frame.
+	 The viewer can also watch several managers, like the objects of a selection. It then shows
+	 the attributes that all the managers share, with the values of the first manager, and an
+	 edit is applied to all the managers as one batch. The batches are serialized so the managers
+	 never end up with the values of two interleaved edits, and the notifications that the batch
+	 itself triggers are coalesced in one refresh.
 	 @see \class Attribute, \class Attribute::Manager
 	 */
     class AttributeViewer : public AttributePanel,
 							public Attr::Listener,
-							public enable_shared_from_this<AttributeViewer>
+							public enable_shared_from_this<AttributeViewer>,
+							private Timer
     {
     private:
 		Attr::sManager					m_attr_manager;
+		vector<Attr::sManager>			m_attr_managers;
+		CriticalSection					m_dirty_lock;
+		set<sAttr>						m_dirty;
+		map<sTag, sAttr>				m_shared;
+		CriticalSection					m_batch_lock;
+		sTag							m_batch;
+		Thread::ThreadID				m_batch_thread;
 		
 		shared_ptr<AttributeComponent> createBoolComponent(Attr::sManager manager, sAttr attr);
 		shared_ptr<AttributeComponent> createNumberComponent(Attr::sManager manager, sAttr attr);
 		shared_ptr<AttributeComponent> createTextComponent(Attr::sManager manager, sAttr attr);
 		shared_ptr<AttributeComponent> createMenuComponent(Attr::sManager manager, sAttr attr);
 		shared_ptr<AttributeComponent> createColorComponent(Attr::sManager manager, sAttr attr);
+		
+		//! Marks the row of an attribute as dirty and starts the timer, the dirty lock must be held.
+		void markDirty(sTag name);
+		
+		//! Create the component of an attribute when its row becomes visible.
+		shared_ptr<AttributeComponent> createAttributeComponent(Attr::sManager manager, sAttr attr) override;
+		
+		//! Refresh the components of the attributes that changed since the last frame.
+		/** The timer is started by the first attribute marked as dirty and stopped once the dirty attributes are drained.
+		 */
+		void timerCallback() override;
         
     public:
         
@@ -75,11 +101,28 @@ namespace Kiwi
 			return panel;
 		}
 		
+		//! Attribute panel creator.
+		/** This static method creates and returns a shared pointer of an AttributePanelComponent that watches several managers.
+		 @param attrsManagers A vector of Attribute::Manager to watch.
+		 @return    A shared pointer of an AttributePanelComponent.
+		 */
+		static inline shared_ptr<AttributeViewer> create(vector<Attr::sManager> const& attrsManagers)
+		{
+			shared_ptr<AttributeViewer> panel = make_shared<AttributeViewer>();
+			panel->setAttributeManagersToWatch(attrsManagers);
+			return panel;
+		}
+		
 		inline Attr::sManager getViewedManager() const noexcept
 		{
 			return m_attr_manager;
 		}
 		
+		inline vector<Attr::sManager> const& getViewedManagers() const noexcept
+		{
+			return m_attr_managers;
+		}
+		
 		//! Returns a shared pointer of this.
 		shared_ptr<AttributeViewer> getShared() {return shared_from_this();}
 		
@@ -90,6 +133,23 @@ namespace Kiwi
 		 */
 		void setAttributeManagerToWatch(Attr::sManager attrsManager);
 		
+		//! Sets several Attribute Managers to watch
+		/** This method Sets the Attribute Managers to watch, the first one gives the values shown by the panel.
+		 @param  attrsManagers  A vector of Attribute::Manager to watch.
+		 */
+		void setAttributeManagersToWatch(vector<Attr::sManager> const& attrsManagers);
+		
+		//! Sets the value of an attribute to all the watched managers.
+		/** The value is written to every manager in one pass as a single change: no other batch can
+		 run during the pass, the notifications that the pass triggers on the calling thread are
+		 coalesced and the row is marked as dirty once at the end, so the panel is refreshed once at
+		 the next frame. The changes made by other threads during the pass are still notified.
+		 @param manager		The manager of the component that has been edited.
+		 @param attr		The attribute.
+		 @param elements	The new value.
+		 */
+		void setAttributeValue(Attr::sManager manager, sAttr attr, ElemVector const& elements) override;
+		
 		//! Receive the notification that an attribute has changed.
 		/** Receive notifications when an attribute is added or removed, or when its value, appearance or behavior changes.
 		 @param manager		The Attribute::Manager that manages the attribute.
@@ -123,6 +183,9 @@ namespace Kiwi
     {
     private:
         sAttributeViewer		m_attr_viewer;
+		
+		//! Creates the viewer of the window if it doesn't exist yet, the viewer is then only rebound.
+		void showViewer();
         
     public:
         InspectorWindow(sAttributeViewer panel = sAttributeViewer());
@@ -139,17 +202,23 @@ namespace Kiwi
 			return window;
 		}
 		
-		//! Replaces the current inspector panel by a new one.
-		/** Replaces the current inspector panel by a new one.
+		//! Shows the attributes of a page.
+		/** Rebinds the viewer of the window to the page, the viewer is only created the first time.
 		 @param page A page.
 		 */
 		void setPage(sPage page);
 		
-		//! Replaces the current inspector panel by a new one.
-		/** Replaces the current inspector panel by a new one.
+		//! Shows the attributes of an object.
+		/** Rebinds the viewer of the window to the object, the viewer is only created the first time.
 		 @param page A Object.
 		 */
 		void setObject(sObject object);
+		
+		//! Shows the attributes shared by several objects.
+		/** Rebinds the viewer of the window to the objects, the viewer is only created the first time.
+		 @param objects The objects.
+		 */
+		void setObjects(vector<sObject> const& objects);
         
         void closeButtonPressed() override;
     };
@@ -0,0 +1,156 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright(c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2(or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#include "jAtomParser.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JATOM PARSER                                    //
+    // ================================================================================ //
+
+    static inline bool isSpace(const char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    static inline bool isDigit(const char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    jAtomParser::Type jAtomParser::getType(const char* begin, const char* end) noexcept
+    {
+        const char* it = begin;
+        if(it != end && (*it == '-' || *it == '+'))
+        {
+            ++it;
+        }
+
+        size_t digits = 0;
+        while(it != end && isDigit(*it))
+        {
+            ++it; ++digits;
+        }
+
+        Type type = Integer;
+        if(it != end && *it == '.')
+        {
+            ++it;
+            type = Real;
+            while(it != end && isDigit(*it))
+            {
+                ++it; ++digits;
+            }
+        }
+        if(!digits)
+        {
+            return Symbol;
+        }
+
+        if(it != end && (*it == 'e' || *it == 'E'))
+        {
+            ++it;
+            type = Real;
+            if(it != end && (*it == '-' || *it == '+'))
+            {
+                ++it;
+            }
+            if(it == end || !isDigit(*it))
+            {
+                return Symbol;
+            }
+            while(it != end && isDigit(*it))
+            {
+                ++it;
+            }
+        }
+        return it == end ? type : Symbol;
+    }
+
+    void jAtomParser::parse(const char* text, const size_t size, ElemVector& elements)
+    {
+        // The words are copied in this buffer only to create the tags and to give a null
+        // terminated string to the number reader, the buffer keeps its capacity from one word to another.
+        string word;
+        const char* it  = text;
+        const char* end = text + size;
+        while(it != end)
+        {
+            while(it != end && isSpace(*it))
+            {
+                ++it;
+            }
+            const char* begin = it;
+            while(it != end && !isSpace(*it))
+            {
+                ++it;
+            }
+            if(begin == it)
+            {
+                break;
+            }
+
+            const Type type = getType(begin, it);
+            if(type == Integer)
+            {
+                const bool negative = (*begin == '-');
+                const char* digit = (*begin == '-' || *begin == '+') ? begin + 1 : begin;
+                unsigned long value = 0;
+                bool overflow = false;
+                for(; digit != it; ++digit)
+                {
+                    const unsigned long figure = static_cast<unsigned long>(*digit - '0');
+                    if(value > (numeric_limits<unsigned long>::max() - figure) / 10)
+                    {
+                        overflow = true;
+                        break;
+                    }
+                    value = value * 10 + figure;
+                }
+                const unsigned long limit = static_cast<unsigned long>(numeric_limits<long>::max()) + (negative ? 1ul : 0ul);
+                if(!overflow && value <= limit)
+                {
+                    elements.push_back(negative ? static_cast<long>(0ul - value) : static_cast<long>(value));
+                    continue;
+                }
+            }
+            word.assign(begin, it);
+            if(type != Symbol)
+            {
+                // The reader of JUCE always uses the dot as decimal separator, strtod depends on the locale.
+                CharPointer_UTF8 number(word.c_str());
+                elements.push_back(CharacterFunctions::readDoubleValue(number));
+            }
+            else
+            {
+                elements.push_back(Tag::create(word));
+            }
+        }
+    }
+
+    void jAtomParser::parse(string const& text, ElemVector& elements)
+    {
+        parse(text.data(), text.size(), elements);
+    }
+}
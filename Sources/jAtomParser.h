@@ -0,0 +1,77 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_JATOMPARSER__
+#define __DEF_KIWI_JATOMPARSER__
+
+#include "jDefs.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JATOM PARSER                                    //
+    // ================================================================================ //
+
+    //! The atom parser converts a text to a vector of elements.
+    /**
+     The text is split on white spaces and each word becomes a long, a double or a tag. A word is a number only if it's entirely a number, with an optional sign, an optional fractional part and an optional exponent, so "-1" is a long, "1e3" and ".5" are doubles and "1st" is a tag. The parser reads the text in place, only the words that become tags are copied to create them.
+     */
+    class jAtomParser
+    {
+    public:
+
+        //! The types of word.
+        enum Type
+        {
+            Symbol  = 0,
+            Integer = 1,
+            Real    = 2
+        };
+
+        //! Retrieve the type of a word.
+        /** The function checks if the word is an integer, a real or a symbol.
+         @param begin The first character of the word.
+         @param end   The character after the last character of the word.
+         @return The type of the word.
+         */
+        static Type getType(const char* begin, const char* end) noexcept;
+
+        //! Parse a text.
+        /** The function appends the elements of the text to the vector.
+         @param text     The text, it doesn't need to be null terminated.
+         @param size     The size of the text in bytes.
+         @param elements The vector of elements.
+         */
+        static void parse(const char* text, const size_t size, ElemVector& elements);
+
+        //! Parse a text.
+        /** The function appends the elements of the text to the vector.
+         @param text     The text.
+         @param elements The vector of elements.
+         */
+        static void parse(string const& text, ElemVector& elements);
+    };
+}
+
+
+#endif
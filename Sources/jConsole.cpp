@@ -26,15 +26,17 @@
 
 namespace Kiwi
 {
-    shared_ptr<Console::History> jConsole::m_history = Console::History::create();
     
     // ================================================================================ //
     //                                  CONSOLE COMPONENT                               //
     // ================================================================================ //
     
     jConsole::jConsole() :
+    m_history(getHistory()),
     m_font(13.f)
     {
+        // The consoles only exist with the graphical interface, the application has created the history.
+        jassert(m_history);
         TableHeaderComponent* header = new TableHeaderComponent();
         header->addColumn(String("ID"),        Column::Id, 30, 20, 50, TableHeaderComponent::defaultFlags, -1);
         header->addColumn(String("Type"),      Column::Type, 30, 20, 50, TableHeaderComponent::defaultFlags, -1);
@@ -57,6 +59,12 @@ namespace Kiwi
         m_table.setHeader(header);
         addAndMakeVisible(m_table);
         
+        m_search.setFont(m_font);
+        m_search.setTextToShowWhenEmpty("Search", Colours::grey);
+        m_search.setTooltip("Filter the messages by text, prefix the text with / to use a regular expression.");
+        m_search.addListener(this);
+        addAndMakeVisible(m_search);
+        
         addKeyListener(Application::getCommandManager().getKeyMappings());
 
     }
@@ -69,7 +77,8 @@ namespace Kiwi
     shared_ptr<jConsole> jConsole::create()
     {
         shared_ptr<jConsole> component = make_shared<jConsole>();
-        m_history->bind(component);
+        component->m_history->setFont(component->m_font);
+        component->m_history->bind(component);
         return component;
     }
 
@@ -79,33 +88,20 @@ namespace Kiwi
     
     void jConsole::copy()
     {
-        String text;
-        SparseSet<int> selection = m_table.getSelectedRows();
-        for(size_t i = 0; i < selection.size(); i++)
+        // The buffer is allocated once for the whole selection instead of growing row by row.
+        SparseSet<int> const& selection = m_table.getSelectedRows();
+        MemoryOutputStream stream;
+        stream.preallocate(size_t(selection.size()) * 64);
+        if(!m_history->write(selection, stream))
         {
-            sConsoleMessage mess = m_history->get(selection[i]);
-            if(mess && !mess->content.empty())
-            {
-                shared_ptr<const Object> object = mess->object.lock();
-                if(object)
-                {
-                    text += toString(object) + " : ";
-                }
-                text += mess->content + "\n";
-            }
+            Console::warning("Some messages of the selection can't be read back from the console log, they haven't been copied.");
         }
-        SystemClipboard::copyTextToClipboard(text);
+        SystemClipboard::copyTextToClipboard(stream.toUTF8());
     }
     
     void jConsole::erase()
     {
-        SparseSet<int> selection = m_table.getSelectedRows();
-        vector<size_t> select;
-        for(size_t i = 0; i < selection.size(); i++)
-        {
-            select.push_back(selection[i]);
-        }
-        m_history->erase(select);
+        m_history->erase(m_table.getSelectedRows());
         m_table.setVerticalPosition(0);
         Application::commandStatusChanged();
     }
@@ -114,9 +110,44 @@ namespace Kiwi
     //                                  HISTORY LISTENER                                //
     // ================================================================================ //
     
-    void jConsole::historyHasChanged(shared_ptr<Console::History> history)
+    void jConsole::historyHasChanged(shared_ptr<jConsoleHistory> history, const size_t start, const size_t end, const bool reset)
     {
         m_table.updateContent();
+        if(reset)
+        {
+            m_table.repaint();
+        }
+        else
+        {
+            // Only repaints the changed rows that are visible.
+            const int rowheight = m_table.getRowHeight();
+            const int first     = m_table.getViewport()->getViewPositionY() / rowheight;
+            const int last      = first + m_table.getViewport()->getViewHeight() / rowheight + 1;
+            for(int row = max(first, int(start)); row <= min(last, int(end) - 1); row++)
+            {
+                m_table.repaintRow(row);
+            }
+        }
+    }
+    
+    shared_ptr<jConsoleHistory> jConsole::getHistory()
+    {
+        return Application::getConsoleHistory();
+    }
+    
+    void jConsole::setHistoryCapacity(const size_t capacity)
+    {
+        shared_ptr<jConsoleHistory> history = getHistory();
+        if(history)
+        {
+            history->setCapacity(capacity);
+        }
+    }
+    
+    bool jConsole::setLogFile(File const& file)
+    {
+        shared_ptr<jConsoleHistory> history = getHistory();
+        return history && history->setLogFile(file);
     }
     
     // ================================================================================ //
@@ -125,7 +156,8 @@ namespace Kiwi
     
     void jConsole::resized()
     {
-        m_table.setBounds(getLocalBounds());
+        m_search.setBounds(getLocalBounds().withHeight(int(m_font.getHeight()) + 10).reduced(2));
+        m_table.setBounds(getLocalBounds().withTrimmedTop(int(m_font.getHeight()) + 10));
         updateRighmostColumnWidth(&m_table.getHeader());
     }
     
@@ -134,7 +166,7 @@ namespace Kiwi
         int width   = m_table.getVisibleContentWidth();
         int rowheight = m_table.getRowHeight();
         g.setColour(Colours::black.withAlpha(0.15f));
-        for(int i = m_table.getHeaderHeight() - 1; i < getHeight(); i+= rowheight)
+        for(int i = m_table.getY() + m_table.getHeaderHeight() - 1; i < getHeight(); i+= rowheight)
         {
              g.drawHorizontalLine(i, 0, width);
         }
@@ -259,7 +291,7 @@ namespace Kiwi
     
     void jConsole::paintRowBackground(Graphics& g, int rowNumber, int width, int height, bool selected)
     {
-        sConsoleMessage mess = m_history->get(rowNumber);
+        shared_ptr<const jConsoleHistory::Entry> mess = m_history->get(rowNumber);
         if(mess)
         {
             if(selected)
@@ -300,7 +332,7 @@ namespace Kiwi
             if(m_table.getVisibleContentWidth() >= width + left)
             {
                 g.setColour(Colours::black.withAlpha(0.15f));
-                g.drawLine(left + width, m_table.getHeaderHeight(), left + width, getHeight());
+                g.drawLine(left + width, m_table.getY() + m_table.getHeaderHeight(), left + width, getHeight());
             }
             
             left += width;
@@ -311,22 +343,32 @@ namespace Kiwi
     {
         g.setColour(Colours::black.brighter(0.4));
         g.setFont(m_font);
-        sConsoleMessage mess = m_history->get(rowNumber);
+        shared_ptr<const jConsoleHistory::Entry> mess = m_history->get(rowNumber);
         if(mess)
         {
             switch (columnId)
             {
                 case Column::Object:
                 {
-                    shared_ptr<const Object> object = mess->object.lock();
-                    if(object)
-                    {
-                        g.drawText(toString(object), 2, 0, width - 4, height, Justification::centredLeft, true);
-                    }
+                    // The label is formatted once per object, nothing is formatted while painting.
+                    g.drawText(mess->name->display, 2, 0, width - 4, height, Justification::centredLeft, true);
                 }
                     break;
                 case Column::Message:
-                    g.drawText(mess->content, 2, 0, width - 4, height, Justification::centredLeft, true);
+                {
+                    int textwidth = width - 4;
+                    if(mess->repeat > 1)
+                    {
+                        const String repeat = String((int64)mess->repeat);
+                        const int repeatwidth = m_font.getStringWidth(repeat) + 8;
+                        g.setColour(Colours::black.withAlpha(0.1f));
+                        g.fillRoundedRectangle(width - repeatwidth - 2, 2, repeatwidth, height - 4, (height - 4) * 0.5f);
+                        g.setColour(Colours::black.brighter(0.4));
+                        g.drawText(repeat, width - repeatwidth - 2, 0, repeatwidth, height, Justification::centred, false);
+                        textwidth -= repeatwidth + 2;
+                    }
+                    g.drawText(mess->content, 2, 0, textwidth, height, Justification::centredLeft, true);
+                }
                     break;
                     
                 default:
@@ -339,22 +381,19 @@ namespace Kiwi
     {
         switch(newSortColumnId)
         {
-            case 1 :
-                m_history->sort(Console::History::Index);
-                break;
-            case 2 :
-                m_history->sort(Console::History::Kind);
+            case Column::Type :
+                m_history->sort(jConsoleHistory::Kind, isForwards);
                 break;
-            case 3 :
-                m_history->sort(Console::History::Name);
+            case Column::Object :
+                m_history->sort(jConsoleHistory::Name, isForwards);
                 break;
-            case 4 :
-                m_history->sort(Console::History::Content);
+            case Column::Message :
+                m_history->sort(jConsoleHistory::Content, isForwards);
                 break;
             default:
+                m_history->sort(jConsoleHistory::Index, isForwards);
                 break;
         }
-        m_table.updateContent();
     }
     
     void jConsole::cellDoubleClicked(int rowNumber, int columnId, const MouseEvent& mouse)
@@ -362,6 +401,62 @@ namespace Kiwi
         // TODO : hilight(if possible) object corresponding to the dblclicked row
     }
     
+    void jConsole::cellClicked(int rowNumber, int columnId, const MouseEvent& mouse)
+    {
+        if(mouse.mods.isPopupMenu())
+        {
+            showFilterMenu(rowNumber);
+        }
+    }
+    
+    void jConsole::showFilterMenu(int rowNumber)
+    {
+        jConsoleHistory::Filter filter = m_history->getFilter();
+        shared_ptr<const jConsoleHistory::Entry> mess = m_history->get(rowNumber);
+        
+        PopupMenu menu;
+        menu.addItem(1, "Posts", true, filter.kinds.empty() || filter.kinds.count(Console::Message::Post));
+        menu.addItem(2, "Warnings", true, filter.kinds.empty() || filter.kinds.count(Console::Message::Warning));
+        menu.addItem(3, "Errors", true, filter.kinds.empty() || filter.kinds.count(Console::Message::Error));
+        menu.addSeparator();
+        menu.addItem(4, "Only this object", mess && !mess->object.expired(), filter.by_object);
+        menu.addItem(5, "Show all");
+        
+        const int result = menu.show();
+        if(result >= 1 && result <= 3)
+        {
+            const Console::Message::Kind kinds[] = {Console::Message::Post, Console::Message::Warning, Console::Message::Error};
+            const Console::Message::Kind kind = kinds[result - 1];
+            if(filter.kinds.empty())
+            {
+                filter.kinds.insert(kinds, kinds + 3);
+            }
+            if(!filter.kinds.erase(kind))
+            {
+                filter.kinds.insert(kind);
+            }
+            if(filter.kinds.size() == 3)
+            {
+                filter.kinds.clear();
+            }
+        }
+        else if(result == 4)
+        {
+            filter.by_object = !filter.by_object;
+            filter.object = filter.by_object ? mess->object : weak_ptr<const Object>();
+        }
+        else if(result == 5)
+        {
+            filter = jConsoleHistory::Filter();
+            m_search.clear();
+        }
+        else
+        {
+            return;
+        }
+        m_history->setFilter(filter);
+    }
+    
     // This is overloaded from TableListBoxModel, and must update any custom components that we're using
     Component* jConsole::refreshComponentForCell(int rowNumber, int columnId, bool /*isRowSelected*/,
                                                           Component* existingComponentToUpdate)
@@ -375,20 +470,15 @@ namespace Kiwi
     // column.
     int jConsole::getColumnAutoSizeWidth(int columnId)
     {
-        if(columnId == Column::Id)
-            return 30;
-        
-        int widest = 32;
-        // find the widest bit of text in this column..
-        for(int i = getNumRows(); --i >= 0;)
+        switch(columnId)
         {
-            sConsoleMessage mess = m_history->get(i);
-            if(mess)
-            {
-                widest = max(widest, m_font.getStringWidth(mess->content));
-            }
+            case Column::Object:
+                return max(32, m_history->getNameMaximumWidth()) + 8;
+            case Column::Message:
+                return max(32, m_history->getContentMaximumWidth()) + 8;
+            default:
+                return 30;
         }
-        return widest + 8;
     }
     
     void jConsole::tableColumnsResized(TableHeaderComponent* tableHeader)
@@ -420,6 +510,37 @@ namespace Kiwi
         }
     }
     
+    // ================================================================================ //
+    //                              TEXT EDITOR LISTENER                                //
+    // ================================================================================ //
+    
+    void jConsole::textEditorTextChanged(TextEditor& editor)
+    {
+        jConsoleHistory::Filter filter = m_history->getFilter();
+        const string text = editor.getText().toStdString();
+        filter.regex = !text.empty() && text[0] == '/';
+        filter.text  = filter.regex ? text.substr(1) : text;
+        m_history->setFilter(filter);
+        
+        // An invalid expression selects nothing, the field shows why.
+        string const& error = m_history->getFilterError();
+        if(error.empty())
+        {
+            editor.setTooltip("Filter the messages by text, prefix the text with / to use a regular expression.");
+            editor.setColour(TextEditor::ColourIds::backgroundColourId, Colours::white);
+        }
+        else
+        {
+            editor.setTooltip("Invalid regular expression: " + String(error));
+            editor.setColour(TextEditor::ColourIds::backgroundColourId, Colours::lightpink);
+        }
+    }
+    
+    void jConsole::textEditorEscapeKeyPressed(TextEditor& editor)
+    {
+        editor.clear();
+    }
+    
     // ================================================================================ //
     //                                  CONSOLE WINDOW                                  //
     // ================================================================================ //
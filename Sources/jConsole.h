@@ -24,7 +24,7 @@
 #ifndef __DEF_KIWI_JCONSOLE__
 #define __DEF_KIWI_JCONSOLE__
 
-#include "jDefs.h"
+#include "jConsoleHistory.h"
 
 namespace Kiwi
 {
@@ -34,11 +34,12 @@ namespace Kiwi
     // ================================================================================ //
     
     class jConsole :
-    public Console::History::Listener,
+    public jConsoleHistory::Listener,
     public Component,
     public ApplicationCommandTarget,
     public TableListBoxModel,
-    public TableHeaderComponent::Listener
+    public TableHeaderComponent::Listener,
+    public TextEditor::Listener
     {
     private:
         enum Column
@@ -49,8 +50,9 @@ namespace Kiwi
             Message = 4
         };
         
-        static shared_ptr<Console::History> m_history;
+        const shared_ptr<jConsoleHistory>  m_history;
         juce::Font                          m_font;
+        TextEditor                          m_search;
         TableListBox                        m_table;
         
         // ================================================================================ //
@@ -61,6 +63,9 @@ namespace Kiwi
         
         void erase();
         
+        //! Show the filter menu.
+        void showFilterMenu(int rowNumber);
+        
     public:
         
         //! The constructor.
@@ -83,10 +88,32 @@ namespace Kiwi
         // ================================================================================ //
         
         //! Receive the notification that an history has changed.
-        /** The function is called by an hisotry when it has changed.
+        /** The function is called by an history at most once per display frame, only the rows that have changed are repainted unless the whole history has to be refreshed.
          @param history The console history.
+         @param start   The first row that has changed.
+         @param end     The row after the last row that has changed.
+         @param reset   True if the whole history should be refreshed.
+         */
+        void historyHasChanged(shared_ptr<jConsoleHistory> history, const size_t start, const size_t end, const bool reset) override;
+        
+        //! Retrieve the history shared by the consoles.
+        /** The function retrieves the history owned by the application, it's created at startup so the messages posted before the first console are kept and released at shutdown. There is no history when the application runs without graphical interface, so no message is kept then.
+         @return The history or null.
+         */
+        static shared_ptr<jConsoleHistory> getHistory();
+        
+        //! Set the maximum number of messages of the history.
+        /** The function sets the maximum number of messages that the console keeps, the oldest messages are dropped when the history is full.
+         @param capacity The maximum number of messages.
+         */
+        static void setHistoryCapacity(const size_t capacity);
+        
+        //! Stream the messages to a log file.
+        /** The function streams the messages of the console to an append-only log file, the messages dropped from the history are then paged back in from the file so the console keeps the whole session.
+         @param file The file or an empty file to stop logging, an existing file is never overwritten.
+         @return True if the file has been created, false if it already exists or can't be created.
          */
-        void historyHasChanged(shared_ptr<Console::History> history) override;
+        static bool setLogFile(File const& file);
         
         // ================================================================================ //
         //                                      COMPONENT                                   //
@@ -160,6 +187,8 @@ namespace Kiwi
         
         void cellDoubleClicked(int rowNumber, int columnId, const MouseEvent& mouse) override;
         
+        void cellClicked(int rowNumber, int columnId, const MouseEvent& mouse) override;
+        
         // This is overloaded from TableListBoxModel, and must update any custom components that we're using
         Component* refreshComponentForCell(int rowNumber, int columnId, bool isRowSelected, Component* existingComponentToUpdate) override;
         
@@ -184,6 +213,20 @@ namespace Kiwi
 
         void updateRighmostColumnWidth (TableHeaderComponent* header);
         
+        // ================================================================================ //
+        //                              TEXT EDITOR LISTENER                                //
+        // ================================================================================ //
+        
+        //! Receive the notification that the search text has changed.
+        /** The function updates the text of the filter of the history.
+         */
+        void textEditorTextChanged(TextEditor& editor) override;
+        
+        //! Receive the notification that the escape key has been pressed in the search field.
+        /** The function clears the search text.
+         */
+        void textEditorEscapeKeyPressed(TextEditor& editor) override;
+        
     };
 
     // ================================================================================ //
@@ -0,0 +1,1443 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright(c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2(or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#include "jConsoleHistory.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  HISTORY SORT INDEX                              //
+    // ================================================================================ //
+
+    jConsoleHistory::SortIndex::SortIndex() :
+    m_root(-1),
+    m_seed(0x9e3779b9)
+    {
+        ;
+    }
+
+    void jConsoleHistory::SortIndex::reset(const size_t capacity, Compare const& compare)
+    {
+        m_nodes.assign(capacity, Node());
+        m_compare = compare;
+        m_root = -1;
+    }
+
+    void jConsoleHistory::SortIndex::clear() noexcept
+    {
+        m_root = -1;
+    }
+
+    void jConsoleHistory::SortIndex::update(const long node) noexcept
+    {
+        m_nodes[node].count = 1 + count(m_nodes[node].left) + count(m_nodes[node].right);
+    }
+
+    void jConsoleHistory::SortIndex::split(const long node, const size_t slot, long& left, long& right)
+    {
+        if(node < 0)
+        {
+            left = right = -1;
+        }
+        else if(m_compare(size_t(node), slot))
+        {
+            split(m_nodes[node].right, slot, m_nodes[node].right, right);
+            left = node;
+            update(node);
+        }
+        else
+        {
+            split(m_nodes[node].left, slot, left, m_nodes[node].left);
+            right = node;
+            update(node);
+        }
+    }
+
+    long jConsoleHistory::SortIndex::merge(const long left, const long right)
+    {
+        if(left < 0 || right < 0)
+        {
+            return left < 0 ? right : left;
+        }
+        else if(m_nodes[left].priority > m_nodes[right].priority)
+        {
+            m_nodes[left].right = merge(m_nodes[left].right, right);
+            update(left);
+            return left;
+        }
+        else
+        {
+            m_nodes[right].left = merge(left, m_nodes[right].left);
+            update(right);
+            return right;
+        }
+    }
+
+    void jConsoleHistory::SortIndex::insert(const size_t slot)
+    {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+
+        Node& node      = m_nodes[slot];
+        node.left       = -1;
+        node.right      = -1;
+        node.priority   = m_seed;
+        node.count      = 1;
+
+        long left, right;
+        split(m_root, slot, left, right);
+        m_root = merge(merge(left, long(slot)), right);
+    }
+
+    long jConsoleHistory::SortIndex::erase(const long node, const size_t slot)
+    {
+        if(node < 0)
+        {
+            return node;
+        }
+        else if(size_t(node) == slot)
+        {
+            return merge(m_nodes[node].left, m_nodes[node].right);
+        }
+        else if(m_compare(slot, size_t(node)))
+        {
+            m_nodes[node].left = erase(m_nodes[node].left, slot);
+        }
+        else
+        {
+            m_nodes[node].right = erase(m_nodes[node].right, slot);
+        }
+        update(node);
+        return node;
+    }
+
+    void jConsoleHistory::SortIndex::erase(const size_t slot)
+    {
+        m_root = erase(m_root, slot);
+    }
+
+    void jConsoleHistory::SortIndex::remap(vector<long> const& slots)
+    {
+        // The shape of the tree is kept, only the slots of the nodes change.
+        vector<Node> nodes(m_nodes.size(), Node());
+        for(size_t i = 0; i < slots.size() && i < m_nodes.size(); i++)
+        {
+            if(slots[i] >= 0)
+            {
+                Node node   = m_nodes[i];
+                node.left   = node.left < 0 ? -1 : slots[size_t(node.left)];
+                node.right  = node.right < 0 ? -1 : slots[size_t(node.right)];
+                nodes[size_t(slots[i])] = node;
+            }
+        }
+        m_root = m_root < 0 ? -1 : slots[size_t(m_root)];
+        m_nodes.swap(nodes);
+    }
+
+    size_t jConsoleHistory::SortIndex::size() const noexcept
+    {
+        return count(m_root);
+    }
+
+    bool jConsoleHistory::SortIndex::contains(const size_t slot) const
+    {
+        long node = m_root;
+        while(node >= 0)
+        {
+            if(size_t(node) == slot)
+            {
+                return true;
+            }
+            node = m_compare(slot, size_t(node)) ? m_nodes[node].left : m_nodes[node].right;
+        }
+        return false;
+    }
+
+    size_t jConsoleHistory::SortIndex::at(size_t rank) const noexcept
+    {
+        long node = m_root;
+        while(node >= 0)
+        {
+            const size_t left = count(m_nodes[node].left);
+            if(rank < left)
+            {
+                node = m_nodes[node].left;
+            }
+            else if(rank == left)
+            {
+                return size_t(node);
+            }
+            else
+            {
+                rank -= left + 1;
+                node = m_nodes[node].right;
+            }
+        }
+        return 0;
+    }
+
+    // ================================================================================ //
+    //                                  JCONSOLE HISTORY                                //
+    // ================================================================================ //
+
+    static inline bool isSameObject(weak_ptr<const Object> const& a, weak_ptr<const Object> const& b) noexcept
+    {
+        return !a.owner_before(b) && !b.owner_before(a);
+    }
+
+    jConsoleHistory::jConsoleHistory(const size_t capacity) :
+    m_entries(max(capacity, size_t(1))),
+    m_head(0),
+    m_size(0),
+    m_counter(0),
+    m_sort(Index),
+    m_forwards(true),
+    m_lost(0),
+    m_limited(0),
+    m_newest(nullptr),
+    m_rate(0.),
+    m_burst(10.),
+    m_pending(false),
+    m_reset(false),
+    m_dirty_start(0),
+    m_dirty_end(0),
+    m_filtering(false),
+    m_log_size(0),
+    m_unpaged_start(0),
+    m_unpaged_end(0),
+    m_unpaged_size(0),
+    m_anonymous(make_shared<Label>())
+    {
+        reindex();
+    }
+
+    jConsoleHistory::~jConsoleHistory()
+    {
+        stopTimer();
+        release();
+        m_writer = nullptr;
+        for(auto const& label : m_labels)
+        {
+            shared_ptr<const Object> owner = label.first.lock();
+            if(owner)
+            {
+                const_pointer_cast<Object>(owner)->unbind(label.second);
+            }
+        }
+        m_listeners.clear();
+    }
+
+    shared_ptr<jConsoleHistory> jConsoleHistory::create(const size_t capacity)
+    {
+        // The timer needs the message manager, a static history would start it before the application exists.
+        jassert(MessageManager::existsAndIsCurrentThread());
+        shared_ptr<jConsoleHistory> history = make_shared<jConsoleHistory>(capacity);
+        if(history)
+        {
+            jConsoleQueue::get();
+            Console::bind(history);
+            history->startTimer(1000 / 60);
+        }
+        return history;
+    }
+
+    void jConsoleHistory::receive(sConsoleMessage message)
+    {
+        if(message)
+        {
+            if(MessageManager::existsAndIsCurrentThread())
+            {
+                append(message->kind, message->content.c_str(), message->content.size(), message->object, Time::getMillisecondCounterHiRes());
+            }
+            else
+            {
+                // The message already exists, the queue only keeps it so its content isn't truncated.
+                jConsoleQueue::get().push(message);
+            }
+        }
+    }
+
+    void jConsoleHistory::Label::notify(Attr::sManager manager, sAttr attr, Attr::Notification type)
+    {
+        if(type == Attr::Notification::ValueChanged)
+        {
+            stale = true;
+        }
+    }
+
+    shared_ptr<jConsoleHistory::Label> jConsoleHistory::intern(weak_ptr<const Object> const& object)
+    {
+        shared_ptr<const Object> owner = object.lock();
+        if(!owner)
+        {
+            return m_anonymous;
+        }
+        auto it = m_labels.find(object);
+        if(it != m_labels.end())
+        {
+            return it->second;
+        }
+        shared_ptr<Label> label = make_shared<Label>();
+        format(*label, toString(owner));
+        m_labels[object] = label;
+        const_pointer_cast<Object>(owner)->bind(label);
+        return label;
+    }
+
+    void jConsoleHistory::format(Label& label, string const& text) const
+    {
+        label.text      = text;
+        label.display   = String::fromUTF8(text.c_str(), int(text.size()));
+        label.width     = m_font.getStringWidth(label.display);
+    }
+
+    void jConsoleHistory::relabel()
+    {
+        bool changed = false;
+        for(auto it = m_labels.begin(); it != m_labels.end();)
+        {
+            // The entries keep their label when the object is deleted or when the label isn't used anymore.
+            shared_ptr<const Object> owner = it->first.lock();
+            if(!owner || it->second.use_count() == 1)
+            {
+                if(owner)
+                {
+                    const_pointer_cast<Object>(owner)->unbind(it->second);
+                }
+                it = m_labels.erase(it);
+                continue;
+            }
+            
+            Label& label = *it->second;
+            if(label.stale.exchange(false))
+            {
+                const string text = toString(owner);
+                if(text != label.text)
+                {
+                    // The entries are removed from the name index and the widths while their label changes.
+                    auto slots = m_objects.find(it->first);
+                    vector<size_t> matched;
+                    if(slots != m_objects.end())
+                    {
+                        for(size_t position : slots->second)
+                        {
+                            m_indexes[Name - 1].erase(position);
+                            measure(m_entries[position], false);
+                            if(m_filtering && m_sort == Name && m_matches.contains(position))
+                            {
+                                m_matches.erase(position);
+                                matched.push_back(position);
+                            }
+                        }
+                    }
+                    format(label, text);
+                    if(slots != m_objects.end())
+                    {
+                        for(size_t position : slots->second)
+                        {
+                            m_indexes[Name - 1].insert(position);
+                            measure(m_entries[position], true);
+                        }
+                    }
+                    for(size_t position : matched)
+                    {
+                        m_matches.insert(position);
+                    }
+                    changed = true;
+                }
+            }
+            ++it;
+        }
+        
+        if(changed)
+        {
+            invalidate();
+        }
+    }
+
+    bool jConsoleHistory::acquire(weak_ptr<const Object> const& object, const double time)
+    {
+        if(m_rate <= 0. || object.expired())
+        {
+            return true;
+        }
+
+        // The bucket holds the number of tokens and the time of the last refill, a queued message can be older than the last one.
+        pair<double, double>& bucket = m_buckets.emplace(object, make_pair(m_burst, time)).first->second;
+        bucket.first    = min(m_burst, bucket.first + max(time - bucket.second, 0.) * 0.001 * m_rate);
+        bucket.second   = max(time, bucket.second);
+        if(bucket.first >= 1.)
+        {
+            bucket.first -= 1.;
+            return true;
+        }
+        return false;
+    }
+
+    jConsoleHistory::Entry* jConsoleHistory::newest(weak_ptr<const Object> const& object)
+    {
+        if(isSameObject(object, weak_ptr<const Object>()))
+        {
+            return m_newest;
+        }
+        auto it = m_objects.find(object);
+        if(it == m_objects.end() || it->second.empty())
+        {
+            return nullptr;
+        }
+        // The slots before the head have been written after the ones that follow it.
+        set<size_t> const& slots = it->second;
+        auto next = slots.lower_bound(m_head);
+        return &m_entries[next != slots.begin() ? *prev(next) : *slots.rbegin()];
+    }
+
+    void jConsoleHistory::append(Console::Message::Kind kind, const char* content, const size_t length, weak_ptr<const Object> const& object, const double time)
+    {
+        Entry* last = newest(object);
+        if(last && last->offset < 0 && last->kind == kind && last->content.compare(0, string::npos, content, length) == 0)
+        {
+            last->repeat++;
+            last->time = time;
+            const size_t position = size_t(last - m_entries.data());
+            invalidate(archived() + (position + m_entries.size() - m_head) % m_entries.size());
+            return;
+        }
+
+        if(!acquire(object, time))
+        {
+            m_limited++;
+            return;
+        }
+
+        // The previous entry of the object is complete, it can be logged.
+        if(last)
+        {
+            journal(*last);
+        }
+        size_t position;
+        if(m_size == m_entries.size())
+        {
+            position = m_head;
+            if(&m_entries[position] == m_newest)
+            {
+                m_newest = nullptr;
+            }
+            journal(m_entries[position]);
+            for(size_t i = 0; i < 3; i++)
+            {
+                m_indexes[i].erase(position);
+            }
+            measure(m_entries[position], false);
+            lookup(position, false);
+            if(m_filtering)
+            {
+                m_matches.erase(position);
+            }
+            m_dropped[m_entries[position].kind]++;
+            m_head = (m_head + 1) % m_entries.size();
+            if(m_writer && m_entries[position].offset >= 0 && archive(m_entries[position].offset))
+            {
+                // The evicted message is paged from the log, the rows aren't shifted in the default order.
+                invalidate(archived() + m_size - 1);
+            }
+            else
+            {
+                invalidate();
+            }
+        }
+        else
+        {
+            position = slot(m_size++);
+            invalidate(archived() + m_size - 1);
+        }
+
+        Entry* entry    = &m_entries[position];
+        entry->index    = m_counter++;
+        entry->kind     = kind;
+        entry->content.assign(content, length);
+        entry->object   = object;
+        entry->name     = intern(object);
+        entry->repeat   = 1;
+        entry->time     = time;
+        entry->offset   = -1;
+        entry->content_width    = m_font.getStringWidth(String::fromUTF8(content, int(length)));
+        if(isSameObject(object, weak_ptr<const Object>()))
+        {
+            m_newest    = entry;
+        }
+
+        for(size_t i = 0; i < 3; i++)
+        {
+            m_indexes[i].insert(position);
+        }
+        measure(*entry, true);
+        lookup(position, true);
+        if(m_filtering && matches(*entry))
+        {
+            m_matches.insert(position);
+        }
+    }
+
+    void jConsoleHistory::measure(Entry const& entry, const bool add)
+    {
+        if(add)
+        {
+            m_name_widths[entry.name->width]++;
+            m_content_widths[entry.content_width]++;
+        }
+        else
+        {
+            auto it = m_name_widths.find(entry.name->width);
+            if(it != m_name_widths.end() && --(it->second) == 0)
+            {
+                m_name_widths.erase(it);
+            }
+            it = m_content_widths.find(entry.content_width);
+            if(it != m_content_widths.end() && --(it->second) == 0)
+            {
+                m_content_widths.erase(it);
+            }
+        }
+    }
+
+    size_t jConsoleHistory::sorted(const size_t rank) const noexcept
+    {
+        if(m_filtering)
+        {
+            return m_matches.at(rank);
+        }
+        else if(m_sort == Index)
+        {
+            return slot(rank);
+        }
+        return m_indexes[m_sort - 1].at(rank);
+    }
+
+    void jConsoleHistory::reindex()
+    {
+        const size_t capacity = m_entries.size();
+        m_indexes[Kind - 1].reset(capacity, [this](size_t a, size_t b)
+        {
+            Entry const& ea = m_entries[a];
+            Entry const& eb = m_entries[b];
+            return ea.kind < eb.kind || (ea.kind == eb.kind && ea.index < eb.index);
+        });
+        m_indexes[Name - 1].reset(capacity, [this](size_t a, size_t b)
+        {
+            Entry const& ea = m_entries[a];
+            Entry const& eb = m_entries[b];
+            const int result = ea.name->text.compare(eb.name->text);
+            return result < 0 || (result == 0 && ea.index < eb.index);
+        });
+        m_indexes[Content - 1].reset(capacity, [this](size_t a, size_t b)
+        {
+            Entry const& ea = m_entries[a];
+            Entry const& eb = m_entries[b];
+            const int result = ea.content.compare(eb.content);
+            return result < 0 || (result == 0 && ea.index < eb.index);
+        });
+        m_matches.reset(capacity, [this](size_t a, size_t b)
+        {
+            return precedes(a, b);
+        });
+
+        m_name_widths.clear();
+        m_content_widths.clear();
+        m_kinds.clear();
+        m_objects.clear();
+        m_words.clear();
+        for(size_t row = 0; row < m_size; row++)
+        {
+            for(size_t i = 0; i < 3; i++)
+            {
+                m_indexes[i].insert(slot(row));
+            }
+            measure(m_entries[slot(row)], true);
+            lookup(slot(row), true);
+        }
+        refilter();
+    }
+
+    void jConsoleHistory::tokenize(string const& text, vector<string>& words)
+    {
+        string word;
+        for(const char c : text)
+        {
+            if(isalnum(static_cast<unsigned char>(c)) || (c & 0x80))
+            {
+                word += char(tolower(static_cast<unsigned char>(c)));
+            }
+            else if(!word.empty())
+            {
+                words.push_back(move(word));
+                word.clear();
+            }
+        }
+        if(!word.empty())
+        {
+            words.push_back(move(word));
+        }
+    }
+
+    void jConsoleHistory::remap(set<size_t>& positions, vector<long> const& slots)
+    {
+        set<size_t> moved;
+        for(size_t position : positions)
+        {
+            moved.insert(size_t(slots[position]));
+        }
+        positions.swap(moved);
+    }
+
+    void jConsoleHistory::lookup(const size_t position, const bool add)
+    {
+        Entry const& entry = m_entries[position];
+        if(add)
+        {
+            m_kinds[entry.kind].insert(position);
+        }
+        else
+        {
+            auto it = m_kinds.find(entry.kind);
+            if(it != m_kinds.end() && it->second.erase(position) && it->second.empty())
+            {
+                m_kinds.erase(it);
+            }
+        }
+
+        if(!isSameObject(entry.object, weak_ptr<const Object>()))
+        {
+            if(add)
+            {
+                m_objects[entry.object].insert(position);
+            }
+            else
+            {
+                auto it = m_objects.find(entry.object);
+                if(it != m_objects.end() && it->second.erase(position) && it->second.empty())
+                {
+                    m_objects.erase(it);
+                }
+            }
+        }
+
+        vector<string> words;
+        tokenize(entry.content, words);
+        for(string const& word : words)
+        {
+            if(add)
+            {
+                m_words[word].insert(position);
+            }
+            else
+            {
+                auto it = m_words.find(word);
+                if(it != m_words.end() && it->second.erase(position) && it->second.empty())
+                {
+                    m_words.erase(it);
+                }
+            }
+        }
+    }
+
+    bool jConsoleHistory::precedes(const size_t a, const size_t b) const
+    {
+        if(m_sort == Index)
+        {
+            return m_entries[a].index < m_entries[b].index;
+        }
+        return m_indexes[m_sort - 1].compare(a, b);
+    }
+
+    static inline bool containsText(string const& text, string const& sequence)
+    {
+        return search(text.begin(), text.end(), sequence.begin(), sequence.end(), [](const char a, const char b)
+        {
+            return tolower(static_cast<unsigned char>(a)) == tolower(static_cast<unsigned char>(b));
+        }) != text.end();
+    }
+
+    bool jConsoleHistory::matches(Entry const& entry) const
+    {
+        if(!m_filter.kinds.empty() && !m_filter.kinds.count(entry.kind))
+        {
+            return false;
+        }
+        if(m_filter.by_object && !isSameObject(entry.object, m_filter.object))
+        {
+            return false;
+        }
+        if(!m_filter.text.empty())
+        {
+            if(m_filter.regex)
+            {
+                return m_filter_error.empty() && regex_search(entry.content, m_regex);
+            }
+            return containsText(entry.content, m_filter.text);
+        }
+        return true;
+    }
+
+    void jConsoleHistory::refilter()
+    {
+        m_filtering = !m_filter.isEmpty();
+        m_matches.clear();
+        if(!m_filtering || !m_filter_error.empty())
+        {
+            return;
+        }
+
+        // The smallest index gives the candidates, then each candidate is checked against the text of the message.
+        vector<size_t> candidates;
+        vector<string> terms;
+        if(!m_filter.by_object && !m_filter.regex)
+        {
+            tokenize(m_filter.text, terms);
+        }
+        if(m_filter.by_object)
+        {
+            auto it = m_objects.find(m_filter.object);
+            if(it != m_objects.end())
+            {
+                candidates.assign(it->second.begin(), it->second.end());
+            }
+        }
+        else if(!terms.empty())
+        {
+            // Each word of the text is contained in a word of the messages that contain the text, the longest word selects the fewest messages.
+            string const& term = *max_element(terms.begin(), terms.end(), [](string const& a, string const& b)
+            {
+                return a.size() < b.size();
+            });
+            for(auto const& word : m_words)
+            {
+                if(word.first.find(term) != string::npos)
+                {
+                    candidates.insert(candidates.end(), word.second.begin(), word.second.end());
+                }
+            }
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+        }
+        else if(!m_filter.kinds.empty())
+        {
+            for(auto kind : m_filter.kinds)
+            {
+                auto it = m_kinds.find(kind);
+                if(it != m_kinds.end())
+                {
+                    candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+                }
+            }
+        }
+        else
+        {
+            candidates.reserve(m_size);
+            for(size_t row = 0; row < m_size; row++)
+            {
+                candidates.push_back(slot(row));
+            }
+        }
+
+        for(size_t position : candidates)
+        {
+            if(matches(m_entries[position]))
+            {
+                m_matches.insert(position);
+            }
+        }
+    }
+
+    void jConsoleHistory::narrow()
+    {
+        vector<size_t> candidates(m_matches.size());
+        for(size_t rank = 0; rank < candidates.size(); rank++)
+        {
+            candidates[rank] = m_matches.at(rank);
+        }
+        for(size_t position : candidates)
+        {
+            if(!matches(m_entries[position]))
+            {
+                m_matches.erase(position);
+            }
+        }
+    }
+
+    static inline bool isRegexMetacharacter(const char c)
+    {
+        return strchr("\\^$.|?*+()[]{}", c) != nullptr;
+    }
+
+    bool jConsoleHistory::restricts(Filter const& filter) const
+    {
+        if(!m_filtering || !m_filter_error.empty() || filter.regex != m_filter.regex)
+        {
+            return false;
+        }
+        if(!m_filter.kinds.empty() && (filter.kinds.empty() || !includes(m_filter.kinds.begin(), m_filter.kinds.end(), filter.kinds.begin(), filter.kinds.end())))
+        {
+            return false;
+        }
+        if(m_filter.by_object && (!filter.by_object || !isSameObject(filter.object, m_filter.object)))
+        {
+            return false;
+        }
+        if(m_filter.text.empty() || filter.text == m_filter.text)
+        {
+            return true;
+        }
+        if(!filter.regex)
+        {
+            return filter.text.find(m_filter.text) != string::npos;
+        }
+        
+        // Literal characters appended to an expression can only narrow its matches, unless they complete an escape sequence or a back reference.
+        const char last = m_filter.text.back();
+        if(filter.text.compare(0, m_filter.text.size(), m_filter.text) != 0 || last == '\\' || isdigit(static_cast<unsigned char>(last)))
+        {
+            return false;
+        }
+        return none_of(filter.text.begin() + long(m_filter.text.size()), filter.text.end(), isRegexMetacharacter);
+    }
+
+    void jConsoleHistory::setFilter(Filter const& filter)
+    {
+        // When the new filter is a restriction of the current one, the messages that match it are among the ones that are already in the view.
+        const bool narrower = restricts(filter);
+        const bool recompile = filter.regex && (!m_filter.regex || filter.text != m_filter.text);
+
+        m_filter = filter;
+        if(!m_filter.regex)
+        {
+            m_filter_error.clear();
+        }
+        else if(recompile)
+        {
+            m_filter_error.clear();
+            try
+            {
+                m_regex = std::regex(m_filter.text, std::regex::icase | std::regex::optimize);
+            }
+            catch(std::regex_error& e)
+            {
+                m_filter_error = e.what();
+            }
+        }
+        
+        if(narrower)
+        {
+            narrow();
+        }
+        else
+        {
+            refilter();
+        }
+        invalidate();
+    }
+
+    jConsoleHistory::Filter const& jConsoleHistory::getFilter() const noexcept
+    {
+        return m_filter;
+    }
+
+    string const& jConsoleHistory::getFilterError() const noexcept
+    {
+        return m_filter_error;
+    }
+
+    void jConsoleHistory::setFont(juce::Font const& font)
+    {
+        m_font = font;
+        m_name_widths.clear();
+        m_content_widths.clear();
+        m_pages.clear();
+        format(*m_anonymous, m_anonymous->text);
+        for(auto const& label : m_labels)
+        {
+            format(*label.second, label.second->text);
+        }
+        for(size_t row = 0; row < m_size; row++)
+        {
+            Entry& entry = m_entries[slot(row)];
+            entry.content_width = m_font.getStringWidth(String::fromUTF8(entry.content.c_str(), int(entry.content.size())));
+            measure(entry, true);
+        }
+    }
+
+    int jConsoleHistory::getNameMaximumWidth() const noexcept
+    {
+        return m_name_widths.empty() ? 0 : m_name_widths.rbegin()->first;
+    }
+
+    int jConsoleHistory::getContentMaximumWidth() const noexcept
+    {
+        return m_content_widths.empty() ? 0 : m_content_widths.rbegin()->first;
+    }
+
+    void jConsoleHistory::timerCallback()
+    {
+        jConsoleQueue& queue = jConsoleQueue::get();
+        while(queue.pop([this](jConsoleQueue::Slot& slot)
+        {
+            // The messages are stamped when they have been posted, not when they are drained.
+            if(slot.message)
+            {
+                append(slot.kind, slot.message->content.c_str(), slot.message->content.size(), slot.message->object, slot.time);
+            }
+            else
+            {
+                append(slot.kind, slot.content, slot.length, slot.object, slot.time);
+            }
+        }))
+        {
+            ;
+        }
+        m_lost += queue.popNumberOfDroppedMessages();
+
+        // Removes the buckets of the deleted objects.
+        for(auto it = m_buckets.begin(); it != m_buckets.end();)
+        {
+            it = it->first.expired() ? m_buckets.erase(it) : ++it;
+        }
+        relabel();
+
+        if(m_unpaged_end > m_unpaged_start && (!m_writer || m_writer->getNumBytesWritten() >= m_unpaged_size))
+        {
+            invalidate(m_unpaged_start);
+            invalidate(m_unpaged_end - 1);
+            m_unpaged_start = m_unpaged_end = 0;
+        }
+
+        if(m_pending)
+        {
+            send();
+        }
+    }
+
+    size_t jConsoleHistory::getCapacity() const noexcept
+    {
+        return m_entries.size();
+    }
+
+    void jConsoleHistory::setCapacity(const size_t capacity)
+    {
+        const size_t newcapacity = max(capacity, size_t(1));
+        if(newcapacity == m_entries.size())
+        {
+            return;
+        }
+
+        // Keeps the newest messages and moves them at the beginning of the new buffer.
+        release();
+        const size_t kept = min(m_size, newcapacity);
+        for(size_t i = 0; i < m_size - kept; i++)
+        {
+            m_dropped[m_entries[slot(i)].kind]++;
+            if(m_writer && m_entries[slot(i)].offset >= 0)
+            {
+                archive(m_entries[slot(i)].offset);
+            }
+        }
+        vector<Entry> entries(newcapacity);
+        for(size_t i = 0; i < kept; i++)
+        {
+            entries[i] = move(m_entries[slot(m_size - kept + i)]);
+        }
+        m_entries.swap(entries);
+        m_head = 0;
+        m_size = kept;
+        reindex();
+        invalidate();
+    }
+
+    size_t jConsoleHistory::size() const noexcept
+    {
+        return (m_filtering ? m_matches.size() : m_size) + archived();
+    }
+
+    size_t jConsoleHistory::archived() const noexcept
+    {
+        return (m_writer && !m_filtering && m_sort == Index) ? m_archive.size() : 0;
+    }
+
+    shared_ptr<const jConsoleHistory::Entry> jConsoleHistory::get(const size_t row) const
+    {
+        const size_t count = size();
+        if(row < count)
+        {
+            const size_t rank       = m_forwards ? row : count - 1 - row;
+            const size_t archive    = archived();
+            if(rank < archive)
+            {
+                shared_ptr<const Entry> entry = page(m_archive[rank]);
+                if(!entry && !m_writer->hasFailed())
+                {
+                    // The record is still in the buffer of the writer, the row is refreshed once it has been written.
+                    m_unpaged_start = (m_unpaged_end > m_unpaged_start) ? min(m_unpaged_start, row) : row;
+                    m_unpaged_end   = max(m_unpaged_end, row + 1);
+                    m_unpaged_size  = m_log_size;
+                    m_writer->flush();
+                }
+                return entry;
+            }
+            // The entries of the ring buffer live as long as the history, they aren't owned by the pointer.
+            return shared_ptr<const Entry>(shared_ptr<const Entry>(), &m_entries[sorted(rank - archive)]);
+        }
+        return nullptr;
+    }
+
+    size_t jConsoleHistory::getNumberOfDroppedMessages(const Console::Message::Kind kind) const noexcept
+    {
+        auto it = m_dropped.find(kind);
+        return (it != m_dropped.end()) ? it->second : 0;
+    }
+
+    size_t jConsoleHistory::getNumberOfLostMessages() const noexcept
+    {
+        return m_lost;
+    }
+
+    size_t jConsoleHistory::getNumberOfLimitedMessages() const noexcept
+    {
+        return m_limited;
+    }
+
+    void jConsoleHistory::setRateLimit(const double rate, const double burst)
+    {
+        m_rate  = max(rate, 0.);
+        m_burst = max(burst, 1.);
+        m_buckets.clear();
+    }
+
+    void jConsoleHistory::sort(const Sort type, const bool forwards)
+    {
+        vector<size_t> matched(m_filtering ? m_matches.size() : 0);
+        for(size_t rank = 0; rank < matched.size(); rank++)
+        {
+            matched[rank] = m_matches.at(rank);
+        }
+        m_sort      = type;
+        m_forwards  = forwards;
+        m_matches.clear();
+        for(size_t position : matched)
+        {
+            m_matches.insert(position);
+        }
+        invalidate();
+    }
+
+    bool jConsoleHistory::write(SparseSet<int> const& rows, OutputStream& stream) const
+    {
+        bool complete = true;
+        for(int i = 0; i < rows.getNumRanges(); i++)
+        {
+            const Range<int> range = rows.getRange(i);
+            for(int row = max(range.getStart(), 0); row < range.getEnd() && size_t(row) < size(); row++)
+            {
+                shared_ptr<const Entry> entry = get(size_t(row));
+                if(!entry && m_writer && m_writer->flush(m_log_size, 5000))
+                {
+                    entry = get(size_t(row));
+                }
+                if(!entry)
+                {
+                    complete = false;
+                    continue;
+                }
+                if(!entry->content.empty())
+                {
+                    if(!entry->name->text.empty())
+                    {
+                        stream.write(entry->name->text.data(), entry->name->text.size());
+                        stream.write(" : ", 3);
+                    }
+                    stream.write(entry->content.data(), entry->content.size());
+                    if(entry->repeat > 1)
+                    {
+                        char repeat[32];
+                        const int length = snprintf(repeat, sizeof(repeat), " (x%llu)", static_cast<unsigned long long>(entry->repeat));
+                        stream.write(repeat, size_t(length));
+                    }
+                    stream.write("\n", 1);
+                }
+            }
+        }
+        return complete;
+    }
+
+    void jConsoleHistory::erase(SparseSet<int> const& rows)
+    {
+        release();
+        const size_t count      = size();
+        const size_t archive    = archived();
+        vector<bool> removed(m_entries.size(), false);
+        vector<bool> unarchived(archive, false);
+        for(int i = 0; i < rows.getNumRanges(); i++)
+        {
+            const Range<int> range = rows.getRange(i);
+            for(size_t row = size_t(max(range.getStart(), 0)); row < min(size_t(max(range.getEnd(), 0)), count); row++)
+            {
+                const size_t rank = m_forwards ? row : count - 1 - row;
+                if(rank < archive)
+                {
+                    unarchived[rank] = true;
+                }
+                else
+                {
+                    removed[sorted(rank - archive)] = true;
+                }
+            }
+        }
+        if(archive)
+        {
+            size_t write = 0;
+            for(size_t read = 0; read < archive; read++)
+            {
+                if(!unarchived[read])
+                {
+                    m_archive[write++] = m_archive[read];
+                }
+            }
+            m_archive.resize(write);
+        }
+
+        // The erased messages leave the indexes while their content is still there.
+        for(size_t row = 0; row < m_size; row++)
+        {
+            const size_t position = slot(row);
+            if(removed[position])
+            {
+                for(size_t i = 0; i < 3; i++)
+                {
+                    m_indexes[i].erase(position);
+                }
+                if(m_filtering)
+                {
+                    m_matches.erase(position);
+                }
+                measure(m_entries[position], false);
+                lookup(position, false);
+            }
+        }
+
+        // Compacts the remaining messages and records where each slot moves in a single pass.
+        vector<long> slots(m_entries.size(), -1);
+        size_t write = 0;
+        for(size_t read = 0; read < m_size; read++)
+        {
+            if(!removed[slot(read)])
+            {
+                if(write != read)
+                {
+                    m_entries[slot(write)] = move(m_entries[slot(read)]);
+                }
+                slots[slot(read)] = long(slot(write));
+                write++;
+            }
+        }
+        m_size = write;
+
+        for(size_t i = 0; i < 3; i++)
+        {
+            m_indexes[i].remap(slots);
+        }
+        m_matches.remap(slots);
+        for(auto& kind : m_kinds)
+        {
+            remap(kind.second, slots);
+        }
+        for(auto& object : m_objects)
+        {
+            remap(object.second, slots);
+        }
+        for(auto& word : m_words)
+        {
+            remap(word.second, slots);
+        }
+        invalidate();
+    }
+
+    void jConsoleHistory::clear()
+    {
+        release();
+        m_head = 0;
+        m_size = 0;
+        m_archive.clear();
+        m_pages.clear();
+        for(size_t i = 0; i < 3; i++)
+        {
+            m_indexes[i].clear();
+        }
+        m_name_widths.clear();
+        m_content_widths.clear();
+        m_kinds.clear();
+        m_objects.clear();
+        m_words.clear();
+        m_matches.clear();
+        invalidate();
+    }
+
+    void jConsoleHistory::journal(Entry& entry)
+    {
+        if(m_writer && entry.offset < 0)
+        {
+            writeLogRecord(m_record, entry.index, entry.kind, entry.repeat, entry.time, entry.name->text, entry.content);
+            // The record is dropped if the writer is late, the entry then stays in memory only.
+            if(m_writer->write(m_record.getData(), m_record.getDataSize()))
+            {
+                entry.offset = m_log_size;
+                m_log_size  += int64(m_record.getDataSize());
+            }
+        }
+    }
+
+    bool jConsoleHistory::archive(const int64 offset)
+    {
+        m_archive.push_back(offset);
+        if(m_archive.size() < 2 * archiveCapacity)
+        {
+            return true;
+        }
+        // The oldest half is forgotten at once so the cost stays constant per message, the records remain in the file.
+        m_archive.erase(m_archive.begin(), m_archive.end() - archiveCapacity);
+        invalidate();
+        return false;
+    }
+
+    void jConsoleHistory::writeLogHeader(MemoryOutputStream& record)
+    {
+        record.reset();
+        record.write("KLOG", 4);
+        record.writeInt(1);
+    }
+
+    void jConsoleHistory::writeLogRecord(MemoryOutputStream& record, const size_t index, const Console::Message::Kind kind, const size_t repeat, const double time, string const& name, string const& content)
+    {
+        record.reset();
+        record.writeInt(0);
+        record.writeInt64(int64(index));
+        record.writeByte(char(kind));
+        record.writeInt(int(repeat));
+        record.writeDouble(time);
+        record.writeInt(int(name.size()));
+        record.write(name.data(), name.size());
+        record.writeInt(int(content.size()));
+        record.write(content.data(), content.size());
+        
+        // Patches the size of the record now that it is known.
+        char* data = static_cast<char*>(const_cast<void*>(record.getData()));
+        const uint32 length = ByteOrder::swapIfBigEndian(uint32(record.getDataSize() - 4));
+        memcpy(data, &length, 4);
+    }
+
+    void jConsoleHistory::release()
+    {
+        for(size_t row = 0; row < m_size; row++)
+        {
+            journal(m_entries[slot(row)]);
+        }
+        m_newest = nullptr;
+    }
+
+    shared_ptr<const jConsoleHistory::Entry> jConsoleHistory::page(const int64 offset) const
+    {
+        auto it = m_pages.find(offset);
+        if(it != m_pages.end())
+        {
+            return it->second;
+        }
+        
+        // The file is mapped again when the record has been written after the last mapping.
+        auto mapped = [this](const int64 end)
+        {
+            if(!m_map || int64(m_map->getSize()) < end)
+            {
+                if(!m_writer || m_writer->getNumBytesWritten() < end)
+                {
+                    return false;
+                }
+                m_map = new MemoryMappedFile(m_log, MemoryMappedFile::readOnly);
+            }
+            return m_map->getData() != nullptr && int64(m_map->getSize()) >= end;
+        };
+        
+        if(!mapped(offset + 4))
+        {
+            return nullptr;
+        }
+        const char* data = static_cast<const char*>(m_map->getData()) + offset;
+        const int64 size = int64(ByteOrder::littleEndianInt(data));
+        if(!mapped(offset + 4 + size))
+        {
+            return nullptr;
+        }
+        
+        MemoryInputStream stream(static_cast<const char*>(m_map->getData()) + offset + 4, size_t(size), false);
+        if(m_pages.size() >= 256)
+        {
+            // The entries still referenced by the caller are kept.
+            for(auto page = m_pages.begin(); page != m_pages.end();)
+            {
+                page = page->second.use_count() == 1 ? m_pages.erase(page) : next(page);
+            }
+        }
+        shared_ptr<Entry> paged = make_shared<Entry>();
+        m_pages[offset] = paged;
+        Entry& entry    = *paged;
+        entry.index     = size_t(stream.readInt64());
+        entry.kind      = Console::Message::Kind(stream.readByte());
+        entry.repeat    = size_t(stream.readInt());
+        entry.time      = stream.readDouble();
+        string name(size_t(max(stream.readInt(), 0)), '\0');
+        stream.read(&name[0], int(name.size()));
+        shared_ptr<Label> label = make_shared<Label>();
+        format(*label, name);
+        entry.name      = label;
+        entry.content.resize(size_t(max(stream.readInt(), 0)));
+        stream.read(&entry.content[0], int(entry.content.size()));
+        entry.content_width = m_font.getStringWidth(String::fromUTF8(entry.content.c_str(), int(entry.content.size())));
+        entry.offset    = offset;
+        return paged;
+    }
+
+    bool jConsoleHistory::setLogFile(File const& file)
+    {
+        // A log is never overwritten nor appended to, the offsets of its records would be wrong.
+        if(file != File() && file.exists())
+        {
+            return false;
+        }
+        release();
+        m_writer    = nullptr;
+        m_map       = nullptr;
+        m_log       = File();
+        m_log_size  = 0;
+        m_archive.clear();
+        m_pages.clear();
+        for(size_t row = 0; row < m_size; row++)
+        {
+            m_entries[slot(row)].offset = -1;
+        }
+        
+        if(file != File())
+        {
+            ScopedPointer<FileOutputStream> stream = new FileOutputStream(file);
+            if(stream->failedToOpen())
+            {
+                invalidate();
+                return false;
+            }
+            m_log       = file;
+            m_writer    = new jLogWriter(stream.release());
+            writeLogHeader(m_record);
+            m_writer->write(m_record.getData(), m_record.getDataSize());
+            m_log_size  = int64(m_record.getDataSize());
+            for(size_t row = 0; row < m_size; row++)
+            {
+                Entry& entry = m_entries[slot(row)];
+                if(newest(entry.object) != &entry)
+                {
+                    journal(entry);
+                }
+            }
+        }
+        invalidate();
+        return true;
+    }
+
+    File jConsoleHistory::getLogFile() const noexcept
+    {
+        return m_log;
+    }
+
+    void jConsoleHistory::bind(shared_ptr<Listener> listener)
+    {
+        if(listener)
+        {
+            m_listeners.insert(listener);
+        }
+    }
+
+    void jConsoleHistory::unbind(shared_ptr<Listener> listener)
+    {
+        if(listener)
+        {
+            m_listeners.erase(listener);
+        }
+    }
+
+    void jConsoleHistory::invalidate() noexcept
+    {
+        m_pending   = true;
+        m_reset     = true;
+    }
+
+    void jConsoleHistory::invalidate(const size_t row) noexcept
+    {
+        if(!m_pending || m_dirty_start == m_dirty_end)
+        {
+            m_dirty_start   = row;
+            m_dirty_end     = row + 1;
+        }
+        else
+        {
+            m_dirty_start   = min(m_dirty_start, row);
+            m_dirty_end     = max(m_dirty_end, row + 1);
+        }
+        m_pending = true;
+    }
+
+    void jConsoleHistory::send()
+    {
+        // Only the appended rows of the default order can be refreshed alone, in the other orders and in the filtered views the rows are shifted.
+        const bool reset    = m_reset || m_filtering || m_sort != Index || !m_forwards;
+        const size_t start  = reset ? 0 : m_dirty_start;
+        const size_t end    = reset ? size() : min(m_dirty_end, size());
+        m_pending       = false;
+        m_reset         = false;
+        m_dirty_start   = 0;
+        m_dirty_end     = 0;
+        vector<shared_ptr<Listener>> listeners;
+        for(auto it = m_listeners.begin(); it != m_listeners.end();)
+        {
+            shared_ptr<Listener> listener = it->lock();
+            if(listener)
+            {
+                listeners.push_back(listener);
+                ++it;
+            }
+            else
+            {
+                it = m_listeners.erase(it);
+            }
+        }
+
+        shared_ptr<jConsoleHistory> history = shared_from_this();
+        for(auto listener : listeners)
+        {
+            listener->historyHasChanged(history, start, end, reset);
+        }
+    }
+}
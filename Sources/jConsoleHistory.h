@@ -0,0 +1,493 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_JCONSOLEHISTORY__
+#define __DEF_KIWI_JCONSOLEHISTORY__
+
+#include "jConsoleQueue.h"
+#include "jLogWriter.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JCONSOLE HISTORY                                //
+    // ================================================================================ //
+
+    //! The console history stores the last messages posted to the console.
+    /**
+     The history is a ring buffer with a fixed capacity, when the buffer is full the oldest message is dropped to make room for the new one. The slots are allocated once so the memory used by the history stays flat however long the application runs.
+     The history maintains an ordered index for each sorting method, the indexes are updated in logarithmic time when a message is added or removed so changing the sorting method only changes the order in which the messages are retrieved.
+     The history also maintains an inverted index of the words of the messages and the sets of messages of each kind and each object, so a filter only checks the messages selected by these indexes and keeps the rows that match in an ordered view, a new message is added to the view in logarithmic time and a filter that only narrows the current one is checked against the view.
+     The identical consecutive messages of an object are folded in its newest entry with a repeat counter, even when other objects post in between. The number of new entries that an object can create per second can also be limited, so a flood costs a constant amount of memory.
+     The history can stream the messages to an append-only log file through a log writer. The messages evicted from the ring buffer are then kept in the log and paged back in from a memory-mapped view of the file when the history is read in the order of arrival without filter, so a large part of the session remains visible while the memory stays flat. A row whose record hasn't been written yet is refreshed once the log writer has written it.
+     The history must only be used by the message thread. The messages posted from other threads go through the console queue that the history drains periodically, so the listeners are always notified on the message thread.
+     @see jConsoleQueue
+     */
+    class jConsoleHistory : public Console::Listener, public enable_shared_from_this<jConsoleHistory>, private juce::Timer
+    {
+    public:
+
+        //! The sorting methods of the history.
+        enum Sort
+        {
+            Index   = 0,
+            Kind    = 1,
+            Name    = 2,
+            Content = 3
+        };
+
+        //! The display name of an object.
+        /**
+         The label is interned, all the entries of an object share the same label that is formatted and measured once. The label listens to the attributes of its object and is marked as stale when one of them changes, the history then formats it again on the message thread.
+         */
+        class Label : public Attr::Listener
+        {
+        public:
+            string          text;
+            String          display;
+            int             width = 0;
+            atomic<bool>    stale;
+            
+            Label() : stale(false) {}
+            
+            //! Receive the notification that an attribute of the object has changed.
+            void notify(Attr::sManager manager, sAttr attr, Attr::Notification type) override;
+        };
+        
+        //! A message of the history.
+        /**
+         The entry is a slot of the ring buffer, its members are reassigned when the slot is reused. The name is the label of the object and the width of the content is measured once with the font of the history when the entry is created. The repeat counter is the number of identical consecutive messages folded in the entry and the time is the last time one of them has been received in milliseconds. The offset is the position of the entry in the log file or -1 if the entry hasn't been logged yet, the newest entry of an object is only logged once the object posts another message.
+         */
+        class Entry
+        {
+        public:
+            size_t                  index;
+            Console::Message::Kind  kind;
+            string                  content;
+            weak_ptr<const Object>  object;
+            shared_ptr<const Label> name;
+            size_t                  repeat;
+            double                  time;
+            int                     content_width;
+            int64                   offset;
+        };
+
+        //! A filter of the history.
+        /**
+         The filter selects the messages by kinds, by object and by text. An empty set of kinds selects all the kinds. A message matches if its content contains the text, ignoring the case, or if its content matches the text as a regular expression. The words index only selects the candidates, the text is always checked against the whole content so the phrases and the punctuation match.
+         */
+        class Filter
+        {
+        public:
+            set<Console::Message::Kind> kinds;
+            bool                        by_object = false;
+            weak_ptr<const Object>      object;
+            string                      text;
+            bool                        regex = false;
+            
+            //! Check if the filter selects all the messages.
+            inline bool isEmpty() const noexcept
+            {
+                return kinds.empty() && !by_object && text.empty();
+            }
+        };
+        
+        //! The history listener.
+        /**
+         The listener is notified on the message thread at most once per display frame with the range of rows that have been appended or modified since the last notification.
+         */
+        class Listener
+        {
+        public:
+            virtual ~Listener() {}
+
+            //! Receive the notification that an history has changed.
+            /** The function is called by an history when it has changed. If the rows have been erased, evicted or reordered, the whole history should be refreshed, otherwise only the rows of the range have changed.
+             @param history The console history.
+             @param start   The first row that has changed.
+             @param end     The row after the last row that has changed.
+             @param reset   True if the whole history should be refreshed.
+             */
+            virtual void historyHasChanged(shared_ptr<jConsoleHistory> history, const size_t start, const size_t end, const bool reset) = 0;
+        };
+
+    private:
+        
+        //! An ordered index of the slots of the history.
+        /**
+         The index is a treap of the slots augmented with the size of the subtrees, so a slot can be inserted, erased or retrieved by its rank in logarithmic time. The nodes are preallocated, one per slot of the history.
+         */
+        class SortIndex
+        {
+        public:
+            typedef function<bool(size_t, size_t)> Compare;
+            
+            SortIndex();
+            void reset(const size_t capacity, Compare const& compare);
+            void clear() noexcept;
+            void insert(const size_t slot);
+            void erase(const size_t slot);
+            size_t at(size_t rank) const noexcept;
+            size_t size() const noexcept;
+            bool contains(const size_t slot) const;
+            void remap(vector<long> const& slots);
+            inline bool compare(const size_t a, const size_t b) const {return m_compare(a, b);}
+            
+        private:
+            class Node
+            {
+            public:
+                long     left;
+                long     right;
+                uint32_t priority;
+                size_t   count;
+            };
+            
+            vector<Node>    m_nodes;
+            long            m_root;
+            Compare         m_compare;
+            uint32_t        m_seed;
+            
+            inline size_t count(const long node) const noexcept {return node < 0 ? 0 : m_nodes[node].count;}
+            void update(const long node) noexcept;
+            void split(const long node, const size_t slot, long& left, long& right);
+            long merge(const long left, const long right);
+            long erase(const long node, const size_t slot);
+        };
+        
+        vector<Entry>                                           m_entries;
+        size_t                                                  m_head;
+        size_t                                                  m_size;
+        size_t                                                  m_counter;
+        SortIndex                                               m_indexes[3];
+        Sort                                                    m_sort;
+        bool                                                    m_forwards;
+        map<Console::Message::Kind, size_t>                     m_dropped;
+        size_t                                                  m_lost;
+        size_t                                                  m_limited;
+        Entry*                                                  m_newest;
+        double                                                  m_rate;
+        double                                                  m_burst;
+        map<weak_ptr<const Object>, pair<double, double>, owner_less<weak_ptr<const Object>>> m_buckets;
+        bool                                                    m_pending;
+        bool                                                    m_reset;
+        size_t                                                  m_dirty_start;
+        size_t                                                  m_dirty_end;
+        juce::Font                                              m_font;
+        map<int, size_t>                                        m_name_widths;
+        map<int, size_t>                                        m_content_widths;
+        map<Console::Message::Kind, set<size_t>>                m_kinds;
+        map<weak_ptr<const Object>, set<size_t>, owner_less<weak_ptr<const Object>>> m_objects;
+        map<string, set<size_t>>                                m_words;
+        Filter                                                  m_filter;
+        bool                                                    m_filtering;
+        std::regex                                              m_regex;
+        string                                                  m_filter_error;
+        SortIndex                                               m_matches;
+        ScopedPointer<jLogWriter>                               m_writer;
+        File                                                    m_log;
+        int64                                                   m_log_size;
+        vector<int64>                                           m_archive;
+        mutable size_t                                          m_unpaged_start;
+        mutable size_t                                          m_unpaged_end;
+        mutable int64                                           m_unpaged_size;
+        MemoryOutputStream                                      m_record;
+        mutable ScopedPointer<MemoryMappedFile>                 m_map;
+        mutable map<int64, shared_ptr<Entry>>                   m_pages;
+        map<weak_ptr<const Object>, shared_ptr<Label>, owner_less<weak_ptr<const Object>>> m_labels;
+        shared_ptr<Label>                                       m_anonymous;
+        set<weak_ptr<Listener>, owner_less<weak_ptr<Listener>>> m_listeners;
+
+        //! Retrieve the slot of a row in the order of arrival.
+        inline size_t slot(const size_t row) const noexcept
+        {
+            return (m_head + row) % m_entries.size();
+        }
+        
+        //! Retrieve the slot of a rank in the current order.
+        size_t sorted(const size_t rank) const noexcept;
+        
+        //! Retrieve the number of logged messages that precede the ring buffer in the current view.
+        size_t archived() const noexcept;
+        
+        //! Write an entry to the log.
+        void journal(Entry& entry);
+        
+        //! Write the entries that are still folding messages to the log and stop folding into them.
+        void release();
+        
+        //! Retrieve the newest entry of an object, the messages of the object are folded into it.
+        Entry* newest(weak_ptr<const Object> const& object);
+        
+        //! Read an entry from the log, the entries that are no more referenced are evicted from the cache.
+        shared_ptr<const Entry> page(const int64 offset) const;
+        
+        //! Keep the offset of an evicted entry, return false if the oldest ones have been forgotten and the rows shifted.
+        bool archive(const int64 offset);
+        
+        //! The maximum number of evicted entries that can be paged back in from the log.
+        static const size_t archiveCapacity = 1 << 19;
+        
+        //! Rebuild the sort indexes and the widths.
+        void reindex();
+        
+        //! Add or remove the widths of an entry.
+        void measure(Entry const& entry, const bool add);
+        
+        //! Add or remove a slot from the kinds, the objects and the words indexes.
+        void lookup(const size_t position, const bool add);
+        
+        //! Move the slots of an index set after a compaction.
+        static void remap(set<size_t>& positions, vector<long> const& slots);
+        
+        //! Split a text in lower case words.
+        static void tokenize(string const& text, vector<string>& words);
+        
+        //! Check if a slot precedes another one in the current order.
+        bool precedes(const size_t a, const size_t b) const;
+        
+        //! Check if an entry matches the filter.
+        bool matches(Entry const& entry) const;
+        
+        //! Rebuild the view of the filter.
+        void refilter();
+        
+        //! Remove the messages that don't match the filter anymore from the view.
+        void narrow();
+        
+        //! Check if a filter only selects messages that are selected by the current filter.
+        bool restricts(Filter const& filter) const;
+
+        //! Retrieve the label of an object.
+        shared_ptr<Label> intern(weak_ptr<const Object> const& object);
+        
+        //! Set the text of a label and measure it.
+        void format(Label& label, string const& text) const;
+        
+        //! Format again the stale labels and remove the unused ones.
+        void relabel();
+        
+        //! Check if an object is allowed to create a new entry.
+        bool acquire(weak_ptr<const Object> const& object, const double time);
+        
+        //! Append a message posted at a time of Time::getMillisecondCounterHiRes.
+        void append(Console::Message::Kind kind, const char* content, const size_t length, weak_ptr<const Object> const& object, const double time);
+        
+        //! Mark the whole history as changed.
+        void invalidate() noexcept;
+        
+        //! Mark a row of the history as changed.
+        void invalidate(const size_t row) noexcept;
+        
+        //! Notify the listeners of the pending changes.
+        void send();
+        
+        //! Drain the console queue and notify the listeners.
+        void timerCallback() override;
+
+    public:
+
+        //! The constructor.
+        /** You should never use this method except if you really know what you do, use the static create method instead.
+         @param capacity The maximum number of messages.
+         */
+        jConsoleHistory(const size_t capacity);
+
+        //! The destructor.
+        /** You should never use this method except if you really know what you do.
+         */
+        ~jConsoleHistory();
+
+        //! The history creation method.
+        /** The function allocates an history and binds it to the console. The history drains the console queue with a timer, so it must be created by the message thread once the message manager exists and never during the static initialization.
+         @param capacity The maximum number of messages.
+         @return The history.
+         */
+        static shared_ptr<jConsoleHistory> create(const size_t capacity = 10000);
+
+        //! Receive the messages.
+        /** The function is called by the console when a message has been posted. If the function isn't called by the message thread, the message is deferred through the console queue without being copied.
+         @param message The message.
+         */
+        void receive(sConsoleMessage message) override;
+
+        //! Retrieve the maximum number of messages.
+        /** The function retrieves the maximum number of messages that the history can hold.
+         @return The capacity.
+         */
+        size_t getCapacity() const noexcept;
+
+        //! Set the maximum number of messages.
+        /** The function sets the maximum number of messages, if the history holds more messages the oldest ones are dropped.
+         @param capacity The capacity.
+         */
+        void setCapacity(const size_t capacity);
+
+        //! Retrieve the number of messages.
+        /** The function retrieves the number of messages in the history that match the filter.
+         @return The number of messages.
+         */
+        size_t size() const noexcept;
+
+        //! Retrieve a message.
+        /** The function retrieves a message of the history in constant time. A message that has been evicted is read back from the log, the pointer stays valid even if the message is then evicted from the cache of the log.
+         @param row The row of the message.
+         @return The message or nullptr if the row is out of range or if the message hasn't been written to the log yet.
+         */
+        shared_ptr<const Entry> get(const size_t row) const;
+
+        //! Retrieve the number of dropped messages.
+        /** The function retrieves the number of messages of a kind that have been dropped because the history was full.
+         @param kind The kind of the messages.
+         @return The number of dropped messages.
+         */
+        size_t getNumberOfDroppedMessages(const Console::Message::Kind kind) const noexcept;
+        
+        //! Retrieve the number of lost messages.
+        /** The function retrieves the number of messages that have been lost because the console queue was full.
+         @return The number of lost messages.
+         */
+        size_t getNumberOfLostMessages() const noexcept;
+        
+        //! Retrieve the number of rate limited messages.
+        /** The function retrieves the number of messages that have been discarded because their object exceeded the rate limit.
+         @return The number of rate limited messages.
+         */
+        size_t getNumberOfLimitedMessages() const noexcept;
+        
+        //! Set the rate limit of the objects.
+        /** The function sets the maximum number of new entries that an object can create per second. The identical consecutive messages that are folded in an entry aren't limited.
+         @param rate  The number of messages per second or zero to disable the limit.
+         @param burst The number of messages that an object can post at once.
+         */
+        void setRateLimit(const double rate, const double burst = 10.);
+
+        //! Set the font used to measure the messages.
+        /** The function sets the font used to measure the width of the names and the contents of the messages.
+         @param font The font.
+         */
+        void setFont(juce::Font const& font);
+        
+        //! Retrieve the width of the widest name.
+        /** The function retrieves the width of the widest object name of the messages in constant time.
+         @return The width in pixels.
+         */
+        int getNameMaximumWidth() const noexcept;
+        
+        //! Retrieve the width of the widest content.
+        /** The function retrieves the width of the widest content of the messages in constant time.
+         @return The width in pixels.
+         */
+        int getContentMaximumWidth() const noexcept;
+        
+        //! Filter the messages.
+        /** The function sets the filter of the history, the rows are then retrieved through the view of the messages that match the filter.
+         @param filter The filter.
+         */
+        void setFilter(Filter const& filter);
+        
+        //! Retrieve the filter.
+        /** The function retrieves the current filter of the history.
+         @return The filter.
+         */
+        Filter const& getFilter() const noexcept;
+        
+        //! Retrieve the error of the filter.
+        /** The function retrieves the reason why the regular expression of the filter can't be used, no message is selected while the expression is invalid.
+         @return The error or an empty string if the filter is valid.
+         */
+        string const& getFilterError() const noexcept;
+        
+        //! Sort the messages.
+        /** The function changes the order in which the messages are retrieved. No message is moved, the function only selects the index to read through.
+         @param type     The sorting method.
+         @param forwards The direction of the sorting.
+         */
+        void sort(const Sort type = Index, const bool forwards = true);
+
+        //! Stream the messages to a log file.
+        /** The function creates an append-only log file, writes the messages of the history to it and then writes each new message on a background thread. The messages evicted from the history are then paged back in from the file. The format of the file is described by writeLogHeader and writeLogRecord.
+         @param file The file or an empty file to stop logging, an existing file is never overwritten.
+         @return True if the file has been created, false if it already exists or can't be created.
+         */
+        bool setLogFile(File const& file);
+        
+        //! Write the header of a log.
+        /** The function writes the header of a log, the four bytes "KLOG" and the version as a 32 bits integer.
+         @param record The stream, it is reset before writing.
+         */
+        static void writeLogHeader(MemoryOutputStream& record);
+        
+        //! Write a message as a log record.
+        /** The function writes a message as a log record. The record starts with its size, then come the index, the kind, the repeat counter, the time in milliseconds, the name and the content, the numbers are little endian and the strings are prefixed by their sizes.
+         @param record  The stream, it is reset before writing.
+         @param index   The index of the message.
+         @param kind    The kind of the message.
+         @param repeat  The repeat counter of the message.
+         @param time    The time of the message.
+         @param name    The name of the object.
+         @param content The content of the message.
+         */
+        static void writeLogRecord(MemoryOutputStream& record, const size_t index, const Console::Message::Kind kind, const size_t repeat, const double time, string const& name, string const& content);
+        
+        //! Retrieve the log file.
+        /** The function retrieves the log file.
+         @return The file or an empty file if the messages aren't logged.
+         */
+        File getLogFile() const noexcept;
+        
+        //! Write messages to a stream.
+        /** The function writes the messages as lines of text to a stream, the name of the object and the repeat counter are added to the content. The function waits for the log writer if some messages haven't been written to the log yet.
+         @param rows   The ranges of rows of the messages in the current order.
+         @param stream The stream.
+         @return true if all the messages have been written, false if some of them couldn't be read back from the log.
+         */
+        bool write(SparseSet<int> const& rows, OutputStream& stream) const;
+        
+        //! Erase messages.
+        /** The function erases messages of the history in a single pass whatever the number of ranges, the erased messages leave the indexes and the slots of the remaining ones are remapped without reading their content again. The logged messages are only removed from the view, the log file is never rewritten.
+         @param rows The ranges of rows of the messages in the current order.
+         */
+        void erase(SparseSet<int> const& rows);
+
+        //! Erase all the messages.
+        /** The function erases all the messages of the history.
+         */
+        void clear();
+
+        //! Add a listener to the history.
+        /** The function adds a listener to the history.
+         @param listener The listener.
+         */
+        void bind(shared_ptr<Listener> listener);
+
+        //! Remove a listener from the history.
+        /** The function removes a listener from the history.
+         @param listener The listener.
+         */
+        void unbind(shared_ptr<Listener> listener);
+    };
+}
+
+
+#endif
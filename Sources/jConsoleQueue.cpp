@@ -0,0 +1,204 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright(c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2(or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#include "jConsoleQueue.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JCONSOLE QUEUE                                  //
+    // ================================================================================ //
+
+    static size_t nextPowerOfTwo(const size_t size) noexcept
+    {
+        size_t power = 2;
+        while(power < size)
+        {
+            power <<= 1;
+        }
+        return power;
+    }
+
+    jConsoleQueue::jConsoleQueue(const size_t size) :
+    m_slots(nextPowerOfTwo(size)),
+    m_mask(m_slots.size() - 1),
+    m_write(0),
+    m_read(0),
+    m_dropped(0)
+    {
+        for(size_t i = 0; i < m_slots.size(); i++)
+        {
+            m_slots[i].sequence.store(i, memory_order_relaxed);
+            m_slots[i].time = 0.;
+            m_slots[i].length = 0;
+            m_slots[i].content[0] = '\0';
+        }
+    }
+
+    jConsoleQueue::~jConsoleQueue()
+    {
+        ;
+    }
+
+    jConsoleQueue& jConsoleQueue::get()
+    {
+        static jConsoleQueue queue(4096);
+        return queue;
+    }
+
+    jConsoleQueue::Slot* jConsoleQueue::acquire() noexcept
+    {
+        size_t position = m_write.load(memory_order_relaxed);
+        Slot* slot;
+        for(;;)
+        {
+            slot = &m_slots[position & m_mask];
+            const size_t sequence = slot->sequence.load(memory_order_acquire);
+            if(sequence == position)
+            {
+                if(m_write.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(sequence < position)
+            {
+                // The consumer is one lap late, the queue is full.
+                m_dropped.fetch_add(1, memory_order_relaxed);
+                return nullptr;
+            }
+            else
+            {
+                position = m_write.load(memory_order_relaxed);
+            }
+        }
+        slot->time = Time::getMillisecondCounterHiRes();
+        return slot;
+    }
+
+    void jConsoleQueue::publish(Slot* slot) noexcept
+    {
+        slot->sequence.store(slot->sequence.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+    bool jConsoleQueue::push(Console::Message::Kind kind, shared_ptr<const Object> const* object, const char* text) noexcept
+    {
+        Slot* slot = acquire();
+        if(!slot)
+        {
+            return false;
+        }
+
+        size_t length = 0;
+        if(text)
+        {
+            while(length < maximum_length && text[length] != '\0')
+            {
+                slot->content[length] = text[length];
+                length++;
+            }
+            // A truncated text doesn't end with the first bytes of a character.
+            if(text[length] != '\0')
+            {
+                while(length > 0 && (static_cast<unsigned char>(text[length]) & 0xc0) == 0x80)
+                {
+                    length--;
+                }
+            }
+        }
+        slot->content[length]   = '\0';
+        slot->length            = length;
+        slot->kind              = kind;
+        if(object)
+        {
+            slot->object        = *object;
+        }
+        publish(slot);
+        return true;
+    }
+
+    bool jConsoleQueue::push(sConsoleMessage const& message) noexcept
+    {
+        Slot* slot = acquire();
+        if(!slot)
+        {
+            return false;
+        }
+        slot->content[0]    = '\0';
+        slot->length        = 0;
+        slot->kind          = message->kind;
+        slot->message       = message;
+        publish(slot);
+        return true;
+    }
+
+    bool jConsoleQueue::pop(function<void(Slot&)> const& fn)
+    {
+        Slot& slot = m_slots[m_read & m_mask];
+        if(slot.sequence.load(memory_order_acquire) != m_read + 1)
+        {
+            return false;
+        }
+        fn(slot);
+        slot.object.reset();
+        slot.message.reset();
+        slot.sequence.store(m_read + m_mask + 1, memory_order_release);
+        m_read++;
+        return true;
+    }
+
+    size_t jConsoleQueue::popNumberOfDroppedMessages() noexcept
+    {
+        return m_dropped.exchange(0, memory_order_relaxed);
+    }
+
+    void jConsoleQueue::post(const char* text) noexcept
+    {
+        get().push(Console::Message::Post, nullptr, text);
+    }
+
+    void jConsoleQueue::post(shared_ptr<const Object> const& object, const char* text) noexcept
+    {
+        get().push(Console::Message::Post, &object, text);
+    }
+
+    void jConsoleQueue::warning(const char* text) noexcept
+    {
+        get().push(Console::Message::Warning, nullptr, text);
+    }
+
+    void jConsoleQueue::warning(shared_ptr<const Object> const& object, const char* text) noexcept
+    {
+        get().push(Console::Message::Warning, &object, text);
+    }
+
+    void jConsoleQueue::error(const char* text) noexcept
+    {
+        get().push(Console::Message::Error, nullptr, text);
+    }
+
+    void jConsoleQueue::error(shared_ptr<const Object> const& object, const char* text) noexcept
+    {
+        get().push(Console::Message::Error, &object, text);
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_JCONSOLEQUEUE__
+#define __DEF_KIWI_JCONSOLEQUEUE__
+
+#include "jDefs.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JCONSOLE QUEUE                                  //
+    // ================================================================================ //
+
+    //! The console queue allows the real-time threads to post messages.
+    /**
+     The queue is a multi-producer single-consumer ring of preallocated slots. Posting a message never locks and never allocates, the text is copied in the slot and truncated on a character boundary if it's too long, and the message is dropped if the queue is full. A message that has already been allocated by the console is queued as is, without copy nor truncation. The message thread drains the shared queue into the console history.
+     @see jConsoleHistory
+     */
+    class jConsoleQueue
+    {
+    public:
+
+        //! The maximum number of characters of a message.
+        static const size_t maximum_length = 255;
+
+        //! A message of the queue.
+        class Slot
+        {
+        public:
+            atomic<size_t>          sequence;
+            Console::Message::Kind  kind;
+            double                  time;
+            size_t                  length;
+            char                    content[maximum_length + 1];
+            weak_ptr<const Object>  object;
+            sConsoleMessage         message;
+        };
+
+    private:
+        vector<Slot>    m_slots;
+        const size_t    m_mask;
+        atomic<size_t>  m_write;
+        size_t          m_read;
+        atomic<size_t>  m_dropped;
+
+        //! Reserve the next slot, return nullptr if the queue is full.
+        Slot* acquire() noexcept;
+
+        //! Make a reserved slot visible to the consumer.
+        void publish(Slot* slot) noexcept;
+
+    public:
+
+        //! The constructor.
+        /** You should never use this method except if you really know what you do, use the static get method instead.
+         @param size The number of slots, rounded up to a power of two.
+         */
+        jConsoleQueue(const size_t size);
+
+        //! The destructor.
+        /** You should never use this method except if you really know what you do.
+         */
+        ~jConsoleQueue();
+
+        //! Retrieve the console queue.
+        /** The function retrieves the queue shared by the application. The queue should be retrieved once on the message thread before any real-time thread uses it.
+         @return The queue.
+         */
+        static jConsoleQueue& get();
+
+        //! Push a message in the queue.
+        /** The function copies a message in a slot of the queue with the current time of Time::getMillisecondCounterHiRes, it never locks nor allocates.
+         @param kind   The kind of the message.
+         @param object The object that posts the message or nullptr.
+         @param text   The text of the message, it's truncated on a character boundary if it's too long.
+         @return true if the message has been pushed, false if the queue is full.
+         */
+        bool push(Console::Message::Kind kind, shared_ptr<const Object> const* object, const char* text) noexcept;
+
+        //! Push a message of the console in the queue.
+        /** The function keeps the message in a slot of the queue with the current time, the content isn't copied nor truncated. It never locks nor allocates.
+         @param message The message.
+         @return true if the message has been pushed, false if the queue is full.
+         */
+        bool push(sConsoleMessage const& message) noexcept;
+
+        //! Pop a message from the queue.
+        /** The function pops the oldest message of the queue and passes it to a function. It must only be called by one thread, the message thread for the shared queue.
+         @param fn The function that receives the message.
+         @return true if a message has been popped, otherwise false.
+         */
+        bool pop(function<void(Slot&)> const& fn);
+
+        //! Retrieve and reset the number of dropped messages.
+        /** The function retrieves the number of messages that have been dropped because the queue was full since the last call.
+         @return The number of dropped messages.
+         */
+        size_t popNumberOfDroppedMessages() noexcept;
+
+        //! Post a standard message.
+        /** The function posts a standard message in the queue, it's safe to call it from a real-time thread.
+         @param text The text of the message.
+         */
+        static void post(const char* text) noexcept;
+
+        //! Post a standard message of an object.
+        /** The function posts a standard message in the queue, it's safe to call it from a real-time thread.
+         @param object The object that posts the message.
+         @param text   The text of the message.
+         */
+        static void post(shared_ptr<const Object> const& object, const char* text) noexcept;
+
+        //! Post a warning.
+        /** The function posts a warning in the queue, it's safe to call it from a real-time thread.
+         @param text The text of the message.
+         */
+        static void warning(const char* text) noexcept;
+
+        //! Post a warning of an object.
+        /** The function posts a warning in the queue, it's safe to call it from a real-time thread.
+         @param object The object that posts the message.
+         @param text   The text of the message.
+         */
+        static void warning(shared_ptr<const Object> const& object, const char* text) noexcept;
+
+        //! Post an error.
+        /** The function posts an error in the queue, it's safe to call it from a real-time thread.
+         @param text The text of the message.
+         */
+        static void error(const char* text) noexcept;
+
+        //! Post an error of an object.
+        /** The function posts an error in the queue, it's safe to call it from a real-time thread.
+         @param object The object that posts the message.
+         @param text   The text of the message.
+         */
+        static void error(shared_ptr<const Object> const& object, const char* text) noexcept;
+    };
+}
+
+
+#endif
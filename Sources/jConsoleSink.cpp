@@ -0,0 +1,232 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright(c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2(or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#include "jConsoleSink.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                              STANDARD OUTPUT STREAM                              //
+    // ================================================================================ //
+
+    class StandardOutputStream : public OutputStream
+    {
+    private:
+        int64 m_position;
+    public:
+        StandardOutputStream() : m_position(0) {}
+
+        void flush() override
+        {
+            fflush(stdout);
+        }
+
+        bool setPosition(int64) override
+        {
+            return false;
+        }
+
+        int64 getPosition() override
+        {
+            return m_position;
+        }
+
+        bool write(const void* data, size_t size) override
+        {
+            const size_t written = fwrite(data, 1, size, stdout);
+            m_position += int64(written);
+            return written == size;
+        }
+    };
+
+    // ================================================================================ //
+    //                                  JCONSOLE SINK                                   //
+    // ================================================================================ //
+
+    jConsoleSink::jConsoleSink(OutputStream* stream, const Format format) :
+    Thread("Kiwi Console Sink"),
+    m_stream(stream),
+    m_format(format),
+    m_counter(0),
+    m_lost(0),
+    m_reported(0)
+    {
+        m_front.reserve(capacity);
+        m_back.reserve(capacity);
+        if(m_format == Binary && m_stream)
+        {
+            jConsoleHistory::writeLogHeader(m_record);
+            m_stream->write(m_record.getData(), m_record.getDataSize());
+        }
+        startThread(3);
+    }
+
+    jConsoleSink::~jConsoleSink()
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread(5000);
+        m_stream = nullptr;
+    }
+
+    shared_ptr<jConsoleSink> jConsoleSink::create(OutputStream* stream, const Format format)
+    {
+        shared_ptr<jConsoleSink> sink = make_shared<jConsoleSink>(stream, format);
+        if(sink)
+        {
+            Console::bind(sink);
+        }
+        return sink;
+    }
+
+    OutputStream* jConsoleSink::createStandardOutputStream()
+    {
+        return new StandardOutputStream();
+    }
+
+    void jConsoleSink::writeJson(MemoryOutputStream& stream, const char* text, const size_t length)
+    {
+        static const char hex[] = "0123456789abcdef";
+        stream.writeByte('"');
+        for(size_t i = 0; i < length; i++)
+        {
+            const char c = text[i];
+            switch(c)
+            {
+                case '"':  stream.write("\\\"", 2); break;
+                case '\\': stream.write("\\\\", 2); break;
+                case '\n': stream.write("\\n", 2); break;
+                case '\r': stream.write("\\r", 2); break;
+                case '\t': stream.write("\\t", 2); break;
+                default:
+                    if(static_cast<unsigned char>(c) < 0x20)
+                    {
+                        const char escape[] = {'\\', 'u', '0', '0', hex[(c >> 4) & 0xf], hex[c & 0xf]};
+                        stream.write(escape, 6);
+                    }
+                    else
+                    {
+                        stream.writeByte(c);
+                    }
+                    break;
+            }
+        }
+        stream.writeByte('"');
+    }
+
+    void jConsoleSink::receive(sConsoleMessage message)
+    {
+        if(message)
+        {
+            // The name is retrieved by the posting thread, the sink thread never touches the objects.
+            shared_ptr<const Object> object = message->object.lock();
+            Pending pending = {message->kind, double(Time::currentTimeMillis()), object ? toString(object) : string(), message};
+            object.reset();
+            
+            // The thread isn't woken up, waking it could lock the caller.
+            const ScopedLock lock(m_lock);
+            if(m_front.size() < capacity)
+            {
+                m_front.push_back(move(pending));
+            }
+            else
+            {
+                m_lost++;
+            }
+        }
+    }
+
+    size_t jConsoleSink::getNumberOfLostMessages() const noexcept
+    {
+        return m_lost.load();
+    }
+
+    void jConsoleSink::format(const Console::Message::Kind kind, const double time, string const& name, string const& content)
+    {
+        const size_t index = m_counter++;
+        if(m_format == Binary)
+        {
+            jConsoleHistory::writeLogRecord(m_record, index, kind, 1, time, name, content);
+            m_batch.write(m_record.getData(), m_record.getDataSize());
+        }
+        else
+        {
+            const char* type = "post";
+            if(kind == Console::Message::Warning)
+            {
+                type = "warning";
+            }
+            else if(kind == Console::Message::Error)
+            {
+                type = "error";
+            }
+            char prefix[96];
+            const int length = snprintf(prefix, sizeof(prefix), "{\"index\":%llu,\"time\":%.0f,\"kind\":\"%s\",\"object\":",
+                                        static_cast<unsigned long long>(index), time, type);
+            m_batch.write(prefix, size_t(length));
+            writeJson(m_batch, name.data(), name.size());
+            m_batch.write(",\"content\":", 11);
+            writeJson(m_batch, content.data(), content.size());
+            m_batch.write("}\n", 2);
+        }
+    }
+
+    void jConsoleSink::drain()
+    {
+        m_batch.reset();
+        {
+            const ScopedLock lock(m_lock);
+            m_front.swap(m_back);
+        }
+        for(Pending const& pending : m_back)
+        {
+            format(pending.kind, pending.time, pending.name, pending.message->content);
+        }
+        m_back.clear();
+        
+        // The messages lost since the last batch are reported in the output itself.
+        const size_t lost = m_lost.load();
+        if(lost > m_reported)
+        {
+            const string content = to_string(lost - m_reported) + " console messages have been lost, the sink couldn't keep up.";
+            format(Console::Message::Warning, double(Time::currentTimeMillis()), string(), content);
+            m_reported = lost;
+        }
+
+        if(m_batch.getDataSize() && m_stream)
+        {
+            m_stream->write(m_batch.getData(), m_batch.getDataSize());
+            m_stream->flush();
+        }
+    }
+
+    void jConsoleSink::run()
+    {
+        while(!threadShouldExit())
+        {
+            wait(20);
+            drain();
+        }
+        drain();
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_JCONSOLESINK__
+#define __DEF_KIWI_JCONSOLESINK__
+
+#include "jConsoleHistory.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JCONSOLE SINK                                   //
+    // ================================================================================ //
+
+    //! The console sink writes the console messages to a stream without graphical interface.
+    /**
+     The sink is used when the application runs from the command line. The thread that posts a message stamps it, retrieves the name of its object while the object is still owned by this thread and adds it to the pending messages of the sink. The background thread of the sink swaps the pending messages, formats each one entirely as a line of JSON or as a record of the binary log format of the history and writes them to the stream in batches. The number of pending messages is bounded, the messages that don't fit are counted and reported by a warning in the output.
+     @see jConsoleHistory::writeLogRecord
+     */
+    class jConsoleSink : public Console::Listener, private juce::Thread
+    {
+    public:
+
+        //! The formats of the sink.
+        enum Format
+        {
+            Json    = 0,
+            Binary  = 1
+        };
+
+    private:
+        
+        //! A message waiting to be written.
+        struct Pending
+        {
+            Console::Message::Kind  kind;
+            double                  time;
+            string                  name;
+            sConsoleMessage         message;
+        };
+        
+        ScopedPointer<OutputStream> m_stream;
+        CriticalSection             m_lock;
+        vector<Pending>             m_front;
+        vector<Pending>             m_back;
+        const Format                m_format;
+        size_t                      m_counter;
+        atomic<size_t>              m_lost;
+        size_t                      m_reported;
+        MemoryOutputStream          m_record;
+        MemoryOutputStream          m_batch;
+        
+        //! The maximum number of pending messages.
+        static const size_t capacity = 4096;
+
+        //! Write a string as a JSON string.
+        static void writeJson(MemoryOutputStream& stream, const char* text, const size_t length);
+        
+        //! Format a message in the batch.
+        void format(const Console::Message::Kind kind, const double time, string const& name, string const& content);
+
+        //! Format the queued messages and write them to the stream.
+        void drain();
+
+        //! The background loop.
+        void run() override;
+
+    public:
+
+        //! The constructor.
+        /** You should never use this method except if you really know what you do, use the static create method instead.
+         @param stream The stream, it will be owned and deleted by the sink.
+         @param format The format of the messages.
+         */
+        jConsoleSink(OutputStream* stream, const Format format);
+
+        //! The destructor.
+        /** The function writes the pending messages and stops the thread.
+         */
+        ~jConsoleSink();
+
+        //! The sink creation method.
+        /** The function allocates a sink and binds it to the console.
+         @param stream The stream, it will be owned and deleted by the sink.
+         @param format The format of the messages.
+         @return The sink.
+         */
+        static shared_ptr<jConsoleSink> create(OutputStream* stream, const Format format = Json);
+
+        //! Create a stream to the standard output.
+        /** The function creates a stream that writes to the standard output of the process.
+         @return The stream.
+         */
+        static OutputStream* createStandardOutputStream();
+
+        //! Receive the messages.
+        /** The function is called by the console when a message has been posted, it can be called by any thread. The message is only stamped and named, it's formatted and written by the thread of the sink.
+         @param message The message.
+         */
+        void receive(sConsoleMessage message) override;
+
+        //! Retrieve the number of lost messages.
+        /** The function retrieves the number of messages that have been lost because the sink had too many pending messages.
+         @return The number of lost messages.
+         */
+        size_t getNumberOfLostMessages() const noexcept;
+    };
+}
+
+
+#endif
@@ -22,6 +22,7 @@
  */
 
 #include "jInstance.h"
+#include "inspector/AttributeView.h"
 
 namespace Kiwi
 {
@@ -36,14 +37,17 @@ namespace Kiwi
         ;
     }
     
-    shared_ptr<jInstance> jInstance::create(sGuiDeviceManager guiDevice, sDspDeviceManager dspDevice, string const& name)
+    shared_ptr<jInstance> jInstance::create(sGuiDeviceManager guiDevice, sDspDeviceManager dspDevice, string const& name, const bool headless)
     {
         shared_ptr<jInstance> that = make_shared<jInstance>(guiDevice, dspDevice, name);
         if(that)
         {
             that->m_instance->addListener(that);
             that->m_instance->createPatcher();
-            that->m_instance->createWindow();
+            if(!headless)
+            {
+                that->m_instance->createWindow();
+            }
         }
         return that;
     }
@@ -52,7 +56,7 @@ namespace Kiwi
     {
         if(patcher && instance == m_instance)
         {
-            cout << "Patcher created" << endl;
+            Console::post("Patcher created.");
             /*
             sGuiWindow window = patcher->createWindow();
             if(window)
@@ -132,29 +136,35 @@ namespace Kiwi
 	
 	void jInstance::showInspector(sObject object)
 	{
-		/*
+		showInspector(object ? vector<sObject>({object}) : vector<sObject>());
+	}
+	
+	void jInstance::setInspectorContent(sObject object)
+	{
+		setInspectorContent(object ? vector<sObject>({object}) : vector<sObject>());
+	}
+	
+	void jInstance::showInspector(vector<sObject> const& objects)
+	{
 		if (m_object_inspector_window)
 		{
-			m_object_inspector_window->setObject(object);
+			m_object_inspector_window->setObjects(objects);
 			m_object_inspector_window->setVisible(true);
 			m_object_inspector_window->toFront(true);
 		}
 		else
 		{
 			m_object_inspector_window = InspectorWindow::create();
-			showInspector(object);
+			showInspector(objects);
 		}
-		*/
 	}
 	
-	void jInstance::setInspectorContent(sObject object)
+	void jInstance::setInspectorContent(vector<sObject> const& objects)
 	{
-		/*
-		if (m_object_inspector_window)
+		if (m_object_inspector_window && m_object_inspector_window->isVisible())
 		{
-			m_object_inspector_window->setObject(object);
+			m_object_inspector_window->setObjects(objects);
 		}
-		*/
 	}
 	
 	void jInstance::savePatcher(sPatcher patcher)
@@ -30,6 +30,8 @@
 
 namespace Kiwi
 {
+	class InspectorWindow;
+	
     
     // ================================================================================ //
     //                                  EDITOR APPLICATION                              //
@@ -45,6 +47,7 @@ namespace Kiwi
         sInstance                               m_instance;
         shared_ptr<MenuBarModel>                m_menu;
 		KiwiLookAndFeel							m_lookandfeel;
+		shared_ptr<InspectorWindow>				m_object_inspector_window;
     public:
         
         //! The constructor.
@@ -58,10 +61,11 @@ namespace Kiwi
         ~jInstance();
         
         //! The instance component creation method.
-        /** The function allocates an instance component.
+        /** The function allocates an instance component. Without graphical interface, the empty patcher is created without window.
+         @param headless True if the application runs without graphical interface.
          @return The instance component.
          */
-        static shared_ptr<jInstance> create(sGuiDeviceManager guiDevice, sDspDeviceManager dspDevice, string const& name);
+        static shared_ptr<jInstance> create(sGuiDeviceManager guiDevice, sDspDeviceManager dspDevice, string const& name, const bool headless = false);
         
         //! Receive the notification that a patcher has been created.
         /** The function is called by the instance when a patcher has been created.
@@ -120,6 +124,16 @@ namespace Kiwi
 		 */
 		void setInspectorContent(sObject objects);
 		
+		//! Brings the object inspector window of a selection to front
+		/** The function brings the object inspector window to front with the attributes shared by the objects, an edit is applied to all of them.
+		 */
+		void showInspector(vector<sObject> const& objects);
+		
+		//! Changes the object inspector content to a selection if visible.
+		/** Changes the object inspector content to the attributes shared by the objects if visible.
+		 */
+		void setInspectorContent(vector<sObject> const& objects);
+		
 		//! Try to save a patcher to disk.
 		/** The function attempts to save a patcher to disk.
 		 */
@@ -0,0 +1,155 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright(c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2(or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#include "jLogWriter.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JLOG WRITER                                     //
+    // ================================================================================ //
+
+    jLogWriter::jLogWriter(OutputStream* stream, const int interval, const size_t capacity) :
+    Thread("Kiwi Log Writer"),
+    m_stream(stream),
+    m_pending(0),
+    m_written(0),
+    m_dropped(0),
+    m_failed(false),
+    m_interval(interval),
+    m_capacity(jmax(capacity, size_t(1 << 16)))
+    {
+        m_front.reserve(1 << 16);
+        m_back.reserve(1 << 16);
+        startThread(3);
+    }
+
+    jLogWriter::~jLogWriter()
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread(5000);
+    }
+
+    bool jLogWriter::write(const void* data, const size_t size)
+    {
+        bool wake, done;
+        {
+            const ScopedLock lock(m_lock);
+            done = !m_failed && m_front.size() + size <= m_capacity;
+            if(done)
+            {
+                m_front.insert(m_front.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+            }
+            wake = m_front.size() >= (1 << 16);
+        }
+        if(done)
+        {
+            m_pending += int64(size);
+        }
+        else
+        {
+            m_dropped += int64(size);
+        }
+        if(wake)
+        {
+            notify();
+        }
+        return done;
+    }
+
+    int64 jLogWriter::getNumBytesAppended() const noexcept
+    {
+        return m_pending.load();
+    }
+
+    int64 jLogWriter::getNumBytesWritten() const noexcept
+    {
+        return m_written.load();
+    }
+
+    int64 jLogWriter::getNumBytesDropped() const noexcept
+    {
+        return m_dropped.load();
+    }
+
+    bool jLogWriter::hasFailed() const noexcept
+    {
+        return m_failed.load();
+    }
+
+    void jLogWriter::flush()
+    {
+        notify();
+    }
+
+    bool jLogWriter::flush(const int64 size, const int timeout)
+    {
+        const uint32 end = Time::getMillisecondCounter() + uint32(jmax(timeout, 0));
+        while(m_written.load() < size && !m_failed)
+        {
+            const int remaining = int(end - Time::getMillisecondCounter());
+            if(remaining <= 0 || size > m_pending.load())
+            {
+                return false;
+            }
+            notify();
+            m_drained.wait(remaining);
+        }
+        return m_written.load() >= size;
+    }
+
+    void jLogWriter::drain()
+    {
+        {
+            const ScopedLock lock(m_lock);
+            m_front.swap(m_back);
+        }
+        if(!m_back.empty())
+        {
+            // A batch that hasn't been written entirely would shift all the next ones, so the writer stops at the first failure.
+            if(!m_failed && m_stream && m_stream->write(m_back.data(), m_back.size()))
+            {
+                m_stream->flush();
+                m_written += int64(m_back.size());
+            }
+            else
+            {
+                m_failed   = true;
+                m_dropped += int64(m_back.size());
+            }
+        }
+        m_back.clear();
+        m_drained.signal();
+    }
+
+    void jLogWriter::run()
+    {
+        while(!threadShouldExit())
+        {
+            wait(m_interval);
+            drain();
+        }
+        drain();
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_JLOGWRITER__
+#define __DEF_KIWI_JLOGWRITER__
+
+#include "jDefs.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JLOG WRITER                                     //
+    // ================================================================================ //
+
+    //! The log writer appends data to a stream on a background thread.
+    /**
+     The data are copied in a buffer by the caller and the background thread swaps the buffer and writes it to the stream in batches, so the caller never waits for the disk. The buffer has a maximum size, if the disk can't keep up the data that don't fit are dropped and counted instead of growing the memory. If the stream fails, the writer stops writing and the data are dropped from then on, so the bytes written always are the beginning of the data appended.
+     */
+    class jLogWriter : private juce::Thread
+    {
+    private:
+        ScopedPointer<OutputStream> m_stream;
+        CriticalSection             m_lock;
+        vector<char>                m_front;
+        vector<char>                m_back;
+        atomic<int64>               m_pending;
+        atomic<int64>               m_written;
+        atomic<int64>               m_dropped;
+        atomic<bool>                m_failed;
+        WaitableEvent               m_drained;
+        const int                   m_interval;
+        const size_t                m_capacity;
+
+        //! Write the pending data.
+        void drain();
+
+        //! The background loop.
+        void run() override;
+
+    public:
+
+        //! The constructor.
+        /** The function creates a writer and starts its thread.
+         @param stream   The stream, it will be owned and deleted by the writer.
+         @param interval The maximum time in milliseconds between two batches.
+         @param capacity The maximum number of bytes waiting to be written.
+         */
+        jLogWriter(OutputStream* stream, const int interval = 100, const size_t capacity = 1 << 24);
+
+        //! The destructor.
+        /** The function writes the pending data and stops the thread.
+         */
+        ~jLogWriter();
+
+        //! Append data.
+        /** The function copies the data in the pending buffer, the data are dropped if the buffer is full or if the stream has failed.
+         @param data The data.
+         @param size The size of the data in bytes.
+         @return true if the data have been appended, false if they have been dropped.
+         */
+        bool write(const void* data, const size_t size);
+
+        //! Retrieve the number of bytes appended.
+        /** The function retrieves the number of bytes that have been appended to the writer, written or not.
+         @return The number of bytes.
+         */
+        int64 getNumBytesAppended() const noexcept;
+
+        //! Retrieve the number of bytes written.
+        /** The function retrieves the number of bytes that have been written to the stream.
+         @return The number of bytes.
+         */
+        int64 getNumBytesWritten() const noexcept;
+        
+        //! Retrieve the number of bytes dropped.
+        /** The function retrieves the number of bytes that have been dropped because the buffer was full or the stream has failed.
+         @return The number of bytes.
+         */
+        int64 getNumBytesDropped() const noexcept;
+        
+        //! Check if the stream has failed.
+        /** The function checks if a write to the stream has failed, nothing is written after a failure.
+         @return true if the stream has failed.
+         */
+        bool hasFailed() const noexcept;
+
+        //! Wake up the writer.
+        /** The function asks the background thread to write the pending data now.
+         */
+        void flush();
+        
+        //! Wait for the data to be written.
+        /** The function wakes up the writer and waits until a number of bytes have been written to the stream.
+         @param size    The number of bytes.
+         @param timeout The maximum time to wait in milliseconds.
+         @return true if the bytes have been written, false if the time is out or the stream has failed.
+         */
+        bool flush(const int64 size, const int timeout);
+    };
+}
+
+
+#endif
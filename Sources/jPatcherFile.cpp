@@ -0,0 +1,448 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright(c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2(or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#include "jPatcherFile.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  PATCHER DECODER                                 //
+    // ================================================================================ //
+
+    jPatcherFile::Decoder::Decoder(const void* data, const size_t size) :
+    m_begin(static_cast<const char*>(data)),
+    m_data(static_cast<const char*>(data)),
+    m_end(static_cast<const char*>(data) + size),
+    m_depth(0),
+    m_valid(true)
+    {
+        ;
+    }
+
+    bool jPatcherFile::Decoder::readInt(int& value)
+    {
+        if(m_end - m_data < 4)
+        {
+            return m_valid = false;
+        }
+        value = int(ByteOrder::littleEndianInt(m_data));
+        m_data += 4;
+        return true;
+    }
+
+    bool jPatcherFile::Decoder::readInt64(int64& value)
+    {
+        if(m_end - m_data < 8)
+        {
+            return m_valid = false;
+        }
+        value = int64(ByteOrder::littleEndianInt64(m_data));
+        m_data += 8;
+        return true;
+    }
+
+    bool jPatcherFile::Decoder::readIndex(int& index)
+    {
+        if(!readInt(index) || index < 0 || size_t(index) >= m_strings.size())
+        {
+            return m_valid = false;
+        }
+        return true;
+    }
+
+    bool jPatcherFile::Decoder::readHeader()
+    {
+        int magic, version, count;
+        if(!readInt(magic) || magic != int(ByteOrder::littleEndianInt("KPAT")) || !readInt(version) || version != jPatcherFile::version || !readInt(count) || count < 0)
+        {
+            return m_valid = false;
+        }
+
+        m_strings.reserve(size_t(count));
+        for(int i = 0; i < count; i++)
+        {
+            int length;
+            if(!readInt(length) || length < 0 || m_end - m_data < length)
+            {
+                return m_valid = false;
+            }
+            m_strings.push_back(String::fromUTF8(m_data, length));
+            m_data += length;
+        }
+
+        // The keys are interned when they are first read, the values are never interned.
+        m_keys.resize(m_strings.size());
+        return true;
+    }
+
+    jPatcherFile::Type jPatcherFile::Decoder::peekType() const noexcept
+    {
+        return (m_valid && m_data != m_end) ? Type(*m_data) : Void;
+    }
+
+    bool jPatcherFile::Decoder::readCount(const Type type, int& count)
+    {
+        if(!m_valid || m_data == m_end || *m_data != char(type))
+        {
+            return m_valid = false;
+        }
+        ++m_data;
+        // Each element takes at least one byte, a larger count is a corrupted file.
+        if(!readInt(count) || count < 0 || m_end - m_data < count)
+        {
+            return m_valid = false;
+        }
+        return true;
+    }
+
+    bool jPatcherFile::Decoder::readKey(Identifier& key)
+    {
+        int index;
+        if(readIndex(index) && m_strings[size_t(index)].isNotEmpty())
+        {
+            Identifier& interned = m_keys[size_t(index)];
+            if(!interned.isValid())
+            {
+                interned = Identifier(m_strings[size_t(index)]);
+            }
+            key = interned;
+            return true;
+        }
+        return m_valid = false;
+    }
+
+    var jPatcherFile::Decoder::readValue()
+    {
+        if(!m_valid || m_data == m_end)
+        {
+            m_valid = false;
+            return var();
+        }
+
+        switch(*m_data)
+        {
+            case Void:
+                ++m_data;
+                return var();
+            case False:
+                ++m_data;
+                return var(false);
+            case True:
+                ++m_data;
+                return var(true);
+            case Int:
+            {
+                int value;
+                ++m_data;
+                return readInt(value) ? var(value) : var();
+            }
+            case Int64:
+            {
+                int64 value;
+                ++m_data;
+                return readInt64(value) ? var(value) : var();
+            }
+            case Double:
+            {
+                int64 bits;
+                ++m_data;
+                if(readInt64(bits))
+                {
+                    double value;
+                    memcpy(&value, &bits, sizeof(double));
+                    return var(value);
+                }
+                return var();
+            }
+            case Text:
+            {
+                int index;
+                ++m_data;
+                return readIndex(index) ? var(m_strings[size_t(index)]) : var();
+            }
+            case Array:
+            {
+                int count;
+                if(m_depth == maxDepth || !readCount(Array, count))
+                {
+                    m_valid = false;
+                    return var();
+                }
+                juce::Array<var> values;
+                values.ensureStorageAllocated(count);
+                ++m_depth;
+                for(int i = 0; i < count && m_valid; i++)
+                {
+                    values.add(readValue());
+                }
+                --m_depth;
+                return var(values);
+            }
+            case Object:
+            {
+                int count;
+                if(m_depth == maxDepth || !readCount(Object, count))
+                {
+                    m_valid = false;
+                    return var();
+                }
+                DynamicObject::Ptr object = new DynamicObject();
+                ++m_depth;
+                for(int i = 0; i < count && m_valid; i++)
+                {
+                    Identifier key;
+                    if(readKey(key))
+                    {
+                        object->setProperty(key, readValue());
+                    }
+                }
+                --m_depth;
+                return var(object.get());
+            }
+            default:
+                m_valid = false;
+                return var();
+        }
+    }
+
+    size_t jPatcherFile::Decoder::getPosition() const noexcept
+    {
+        return size_t(m_data - m_begin);
+    }
+
+    bool jPatcherFile::Decoder::isValid() const noexcept
+    {
+        return m_valid;
+    }
+
+    // ================================================================================ //
+    //                              BINARY PATCHER WRITER                               //
+    // ================================================================================ //
+
+    class BinaryPatcherWriter
+    {
+    private:
+        OutputStream&       m_stream;
+        map<String, int>    m_indices;
+        vector<String>      m_strings;
+
+        void intern(String const& string)
+        {
+            if(m_indices.insert(make_pair(string, int(m_strings.size()))).second)
+            {
+                m_strings.push_back(string);
+            }
+        }
+
+        void collect(var const& value)
+        {
+            if(value.isString())
+            {
+                intern(value.toString());
+            }
+            else if(const Array<var>* values = value.getArray())
+            {
+                for(var const& element : *values)
+                {
+                    collect(element);
+                }
+            }
+            else if(DynamicObject* object = value.getDynamicObject())
+            {
+                NamedValueSet const& properties = object->getProperties();
+                for(int i = 0; i < properties.size(); i++)
+                {
+                    intern(properties.getName(i).toString());
+                    collect(properties.getValueAt(i));
+                }
+            }
+        }
+
+        bool writeValue(var const& value)
+        {
+            bool done = true;
+            if(value.isBool())
+            {
+                done = m_stream.writeByte(char(bool(value) ? jPatcherFile::True : jPatcherFile::False));
+            }
+            else if(value.isInt())
+            {
+                done = m_stream.writeByte(char(jPatcherFile::Int)) && m_stream.writeInt(int(value));
+            }
+            else if(value.isInt64())
+            {
+                done = m_stream.writeByte(char(jPatcherFile::Int64)) && m_stream.writeInt64(int64(value));
+            }
+            else if(value.isDouble())
+            {
+                done = m_stream.writeByte(char(jPatcherFile::Double)) && m_stream.writeDouble(double(value));
+            }
+            else if(value.isString())
+            {
+                done = m_stream.writeByte(char(jPatcherFile::Text)) && m_stream.writeInt(m_indices[value.toString()]);
+            }
+            else if(const Array<var>* values = value.getArray())
+            {
+                done = m_stream.writeByte(char(jPatcherFile::Array)) && m_stream.writeInt(values->size());
+                for(int i = 0; i < values->size() && done; i++)
+                {
+                    done = writeValue(values->getReference(i));
+                }
+            }
+            else if(DynamicObject* object = value.getDynamicObject())
+            {
+                NamedValueSet const& properties = object->getProperties();
+                done = m_stream.writeByte(char(jPatcherFile::Object)) && m_stream.writeInt(properties.size());
+                for(int i = 0; i < properties.size() && done; i++)
+                {
+                    done = m_stream.writeInt(m_indices[properties.getName(i).toString()]) && writeValue(properties.getValueAt(i));
+                }
+            }
+            else
+            {
+                done = m_stream.writeByte(char(jPatcherFile::Void));
+            }
+            return done;
+        }
+
+    public:
+        BinaryPatcherWriter(OutputStream& stream) : m_stream(stream)
+        {
+            ;
+        }
+
+        bool write(var const& patcher)
+        {
+            collect(patcher);
+
+            bool done = m_stream.write("KPAT", 4) && m_stream.writeInt(jPatcherFile::version) && m_stream.writeInt(int(m_strings.size()));
+            for(size_t i = 0; i < m_strings.size() && done; i++)
+            {
+                const size_t length = m_strings[i].getNumBytesAsUTF8();
+                done = m_stream.writeInt(int(length)) && m_stream.write(m_strings[i].toRawUTF8(), length);
+            }
+            return done && writeValue(patcher);
+        }
+    };
+
+    // ================================================================================ //
+    //                                  JPATCHER FILE                                   //
+    // ================================================================================ //
+
+    String jPatcherFile::getExtension(const Format format)
+    {
+        return format == Binary ? ".kiwibinary" : ".kiwipatcher";
+    }
+
+    jPatcherFile::Format jPatcherFile::getFormat(File const& file)
+    {
+        char magic[4] = {0, 0, 0, 0};
+        ScopedPointer<FileInputStream> stream(file.createInputStream());
+        if(stream && stream->read(magic, 4) == 4 && memcmp(magic, "KPAT", 4) == 0)
+        {
+            return Binary;
+        }
+        return Json;
+    }
+
+    bool jPatcherFile::read(File const& file, var& patcher)
+    {
+        if(!file.existsAsFile())
+        {
+            return false;
+        }
+
+        if(getFormat(file) == Binary)
+        {
+            MemoryMappedFile mapped(file, MemoryMappedFile::readOnly);
+            if(mapped.getData())
+            {
+                return readBinary(mapped.getData(), mapped.getSize(), patcher);
+            }
+
+            MemoryBlock block;
+            return file.loadFileAsData(block) && readBinary(block.getData(), block.getSize(), patcher);
+        }
+
+        const Result result = JSON::parse(file.loadFileAsString(), patcher);
+        return result.wasOk();
+    }
+
+    bool jPatcherFile::write(var const& patcher, File const& file, const Format format)
+    {
+        TemporaryFile temporary(file);
+        {
+            ScopedPointer<FileOutputStream> stream(temporary.getFile().createOutputStream());
+            if(!stream)
+            {
+                return false;
+            }
+
+            if(format == Binary)
+            {
+                if(!writeBinary(patcher, *stream))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                JSON::writeToStream(*stream, patcher);
+            }
+
+            stream->flush();
+            if(stream->getStatus().failed())
+            {
+                return false;
+            }
+        }
+        return temporary.overwriteTargetFileWithTemporary();
+    }
+
+    bool jPatcherFile::convert(File const& source, File const& destination, const Format format)
+    {
+        var patcher;
+        return read(source, patcher) && write(patcher, destination, format);
+    }
+
+    bool jPatcherFile::readBinary(const void* data, const size_t size, var& patcher)
+    {
+        Decoder decoder(data, size);
+        if(decoder.readHeader())
+        {
+            var root = decoder.readValue();
+            if(decoder.isValid())
+            {
+                patcher = root;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool jPatcherFile::writeBinary(var const& patcher, OutputStream& stream)
+    {
+        BinaryPatcherWriter writer(stream);
+        return writer.write(patcher);
+    }
+}
@@ -0,0 +1,194 @@
+/*
+ ==============================================================================
+
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+
+ Details of these licenses can be found at: www.gnu.org/licenses
+
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_JPATCHERFILE__
+#define __DEF_KIWI_JPATCHERFILE__
+
+#include "jDefs.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  JPATCHER FILE                                   //
+    // ================================================================================ //
+
+    //! The patcher file reads and writes the patchers in the JSON format or in the binary format.
+    /**
+     The binary format holds the same tree as the JSON format so the conversion is lossless. All the strings, keys and values, are stored once in a table at the beginning of the file and the tree refers to them by index, then the values follow in the order of the tree, the objects and the links of a patcher are contiguous arrays. A binary file is memory mapped and read without text parsing, only the strings used as keys are interned and only once.
+     
+     The file starts with the magic "KPAT" and the version, followed by the number of strings and the strings, each as a 32 bits size and the UTF-8 characters, then the root value. A value is a type byte followed by its content, all the numbers are little endian.
+     */
+    class jPatcherFile
+    {
+    public:
+
+        //! The formats of the file.
+        enum Format
+        {
+            Json    = 0,
+            Binary  = 1
+        };
+
+        //! The types of the values of the binary format.
+        enum Type
+        {
+            Void    = 0,
+            False   = 1,
+            True    = 2,
+            Int     = 3,
+            Int64   = 4,
+            Double  = 5,
+            Text    = 6,
+            Array   = 7,
+            Object  = 8
+        };
+
+        //! The version of the binary format.
+        static const int version = 1;
+
+        //! The maximum number of nested arrays and objects, a deeper tree is a corrupted file.
+        static const int maxDepth = 256;
+
+        //! The decoder reads the values of the binary format.
+        /**
+         The decoder reads the values one after the other from a block of memory, it can read a complete tree with readValue() or walk it with readCount() and readKey() to read only a part of the tree at a time.
+         */
+        class Decoder
+        {
+        private:
+            const char*         m_begin;
+            const char*         m_data;
+            const char*         m_end;
+            vector<String>      m_strings;
+            vector<Identifier>  m_keys;
+            int                 m_depth;
+            bool                m_valid;
+
+            bool readInt(int& value);
+            bool readInt64(int64& value);
+            bool readIndex(int& index);
+
+        public:
+
+            //! The constructor.
+            /** The data must stay valid while the decoder reads it.
+             @param data The data.
+             @param size The size of the data in bytes.
+             */
+            Decoder(const void* data, const size_t size);
+
+            //! Read the header.
+            /** The function checks the magic and the version and reads the string table.
+             @return true if the header is valid, otherwise false.
+             */
+            bool readHeader();
+
+            //! Retrieve the type of the next value without reading it.
+            Type peekType() const noexcept;
+
+            //! Read the number of elements of an array or of properties of an object.
+            /** The function reads the type and the number of elements of the next value, the elements follow.
+             @param type  The expected type, Array or Object.
+             @param count The number of elements.
+             @return true if the next value has the type, otherwise false.
+             */
+            bool readCount(const Type type, int& count);
+
+            //! Read the key of a property of an object.
+            /** The key is interned the first time its string is read as a key.
+             */
+            bool readKey(Identifier& key);
+
+            //! Read the next value and all its elements.
+            /** The value is invalid if the arrays and objects are nested deeper than maxDepth.
+             */
+            var readValue();
+
+            //! Retrieve the number of bytes read.
+            size_t getPosition() const noexcept;
+
+            //! Check if the data read so far are valid.
+            bool isValid() const noexcept;
+        };
+
+        //! Retrieve the extension of a format.
+        /** The function retrieves the extension of the files of a format.
+         @param format The format.
+         @return The extension with the dot.
+         */
+        static String getExtension(const Format format);
+
+        //! Retrieve the format of a file.
+        /** The function reads the first bytes of the file to find its format.
+         @param file The file.
+         @return The format.
+         */
+        static Format getFormat(File const& file);
+
+        //! Read a patcher.
+        /** The function reads a patcher in any format, the binary files are memory mapped.
+         @param file    The file.
+         @param patcher The patcher.
+         @return true if the file has been read, otherwise false.
+         */
+        static bool read(File const& file, var& patcher);
+
+        //! Write a patcher.
+        /** The function writes a patcher to a temporary file that replaces the file once complete.
+         @param patcher The patcher.
+         @param file    The file.
+         @param format  The format.
+         @return true if the file has been written, otherwise false.
+         */
+        static bool write(var const& patcher, File const& file, const Format format);
+
+        //! Convert a patcher file.
+        /** The function reads a file in any format and writes it in a format.
+         @param source      The file to read.
+         @param destination The file to write.
+         @param format      The format of the file to write.
+         @return true if the file has been converted, otherwise false.
+         */
+        static bool convert(File const& source, File const& destination, const Format format);
+
+        //! Read a patcher in the binary format.
+        /** The function reads a patcher from a block of memory, like a memory mapped file.
+         @param data    The data.
+         @param size    The size of the data in bytes.
+         @param patcher The patcher.
+         @return true if the data is a valid patcher, otherwise false.
+         */
+        static bool readBinary(const void* data, const size_t size, var& patcher);
+
+        //! Write a patcher in the binary format.
+        /** The function writes the string table and the tree of a patcher.
+         @param patcher The patcher.
+         @param stream  The stream.
+         @return true if the patcher has been written, otherwise false.
+         */
+        static bool writeBinary(var const& patcher, OutputStream& stream);
+    };
+}
+
+
+#endif